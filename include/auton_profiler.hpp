@@ -0,0 +1,95 @@
+#ifndef _AUTON_PROFILER_HPP_
+#define _AUTON_PROFILER_HPP_
+
+#include "api.h"
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Declaration for the static AutonProfiler class
+ *
+ * AutonProfiler breaks down where the time of an auton run goes, so autons can be fit into their time limit
+ * (15 seconds, 60 seconds for skills) without guessing
+ *
+ * Every drivetrain motion (moveTo, turnTo, pure pursuit, motion profiled paths, blocking or queued) is recorded as a step:
+ *      wait: time since the previous motion ended (explicit delays, waiting on subsystems)
+ *      motion: time spent moving before the motion came within its exit tolerance
+ *      settle: time spent within the exit tolerance before the motion exited (or stuck, if it never came within tolerance)
+ * Motions are executed one at a time, so the steps (and the wait after the last motion) add up to the length of the run
+ *
+ * With AUTON_PROFILING defined (include/macros.h), autonomous() profiles every run and the report is written to the
+ * terminal when the run ends: when the auton returns, or when the period ends (disabled()), since autons that hold their
+ * position until the end of the period never return
+ * It can be rewritten afterwards with writeReport, ex: from opcontrol after a practice run
+ */
+
+class AutonProfiler final {
+public:
+
+    // one drivetrain motion and the wait before it, times are in milliseconds
+    struct Step {
+        char label[32];         // motion type and target
+        uint32_t startTime;     // from the start of the run
+        uint32_t waitTime;
+        uint32_t motionTime;
+        uint32_t settleTime;
+    };
+
+    // Starts profiling a run that should take at most budget milliseconds, clears the previous run
+    // MUTEX LOCKING
+    static void start(uint32_t budget);
+    // Stops profiling, the time since the last motion is counted as wait
+    // MUTEX LOCKING
+    static void stop();
+
+    // Records a motion that started at startTime (from pros::millis) and ends now, settleTime milliseconds of which were
+    // spent settling; label is a printf style format describing the motion
+    // Does nothing while not profiling
+    // MUTEX LOCKING
+    static void recordMotion(uint32_t startTime, uint32_t settleTime, const char* label, ...)
+        __attribute__((format(printf, 3, 4)));
+
+    // Returns the length (milliseconds) of the last run, or of the current run so far
+    // MUTEX LOCKING
+    static uint32_t getRunTime();
+    // Returns the time limit (milliseconds) of the last run
+    // MUTEX LOCKING
+    static uint32_t getBudget();
+
+    // Writes the breakdown of the last run to file: the totals against the budget, every step as csv, and the steps
+    // with the largest settle and wait times
+    // MUTEX LOCKING
+    static void writeReport(FILE* file = stdout);
+
+private:
+
+    // number of steps recorded per run, later motions are only counted in the totals
+    static constexpr size_t stepCapacity = 128;
+    // number of steps listed as the largest settle and wait times
+    static constexpr size_t reportedSteps = 3;
+
+    // Writes the steps with the largest value of member to file
+    // NEEDS MUTEX COVER
+    static void writeLargest(FILE* file, const char* name, uint32_t Step::*member);
+
+    static Step steps[stepCapacity];
+    static size_t stepCount;
+
+    static bool running;
+    // pros::millis when the run started, when the last motion ended, and when the run ended
+    static uint32_t runStartTime;
+    static uint32_t lastEndTime;
+    static uint32_t runEndTime;
+    static uint32_t budget;
+
+    // totals of every step, including those not stored
+    static uint32_t totalWait;
+    static uint32_t totalMotion;
+    static uint32_t totalSettle;
+
+    static pros::Mutex mutex;
+
+};
+
+#endif
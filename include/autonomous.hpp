@@ -4,6 +4,10 @@
 #include "main.h" // for forward declaration for autonomous
 #include "drivetrain.hpp" // for drivetrain movement
 #include "systems.hpp" // for subsystem 3 movement
+#include "sensor_hub.hpp" // for sensor readings
+#include "commands.hpp" // for commands run concurrently by CommandScheduler
+#include "auton_profiler.hpp" // for the auton time breakdown
+#include "robustness_trial.hpp" // for marking failed robustness trials
 #include "util/conversions.hpp" // for literals
 #include "gui/display.hpp" // for DisplayControl::Auton, upperAutons, lowerAutons
 
@@ -19,6 +23,7 @@
 using namespace drive;
 using namespace motor_control;
 using namespace conversions;
+using namespace commands;
 
 using Subposition = Lift::Subposition;
 
@@ -62,7 +67,12 @@ void awp();
 void lowerGoalRush();
 void skills();
 
+// Ends the run started by autonomous: writes the auton profile and ends the robustness trial if they are enabled
+// (include/macros.h), called when the auton returns and when the period ends (from disabled)
+// a trial the auton has not ended by the end of the period fails, does nothing if the run already ended
+void endAutonRun(bool autonReturned);
+
 // specialized exit conditions for the goal rush
-bool goalRushExitConditions(long double dist, bool firstLoop, bool reset);
+extern const ExitConditions goalRushExitConditions;
 
 #endif
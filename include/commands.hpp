@@ -0,0 +1,57 @@
+#ifndef _COMMANDS_HPP_
+#define _COMMANDS_HPP_
+
+/**
+ * Includes all commands/ header files, and declares the functions used to build commands
+ *
+ * ex: run a turn while the lift raises, then drive forward until 2 seconds pass
+ *      CommandScheduler::runUntilFinished(sequence({
+ *          parallel({
+ *              motion([]{ return base.turnToAsync(90_deg); }),
+ *              liftTo(lift.raise)
+ *          }),
+ *          withTimeout(motion([]{ return base.moveForwardAsync(3_ft); }), 2000)
+ *      }));
+ */
+
+#include "commands/command.hpp"
+#include "commands/command_groups.hpp"
+#include "commands/command_scheduler.hpp"
+
+namespace commands {
+
+    // runs action once, requiring subsystems
+    CommandPtr instant(std::function<void()> action, std::initializer_list<Subsystem> subsystems = {});
+    // runs the given functions as a command, see FunctionalCommand
+    CommandPtr functional(
+        std::function<void()> initialize, std::function<void()> execute,
+        std::function<bool()> isFinished, std::function<void(bool)> end,
+        std::initializer_list<Subsystem> subsystems = {}
+    );
+    // waits time milliseconds
+    CommandPtr waitFor(uint32_t time);
+    // waits until condition returns true
+    CommandPtr waitUntil(std::function<bool()> condition);
+    // queues the motion started by startMotion (an Async movement function) and waits for it to finish
+    CommandPtr motion(std::function<Drivetrain::MotionHandle()> startMotion);
+    // queues the motion started by startMotion and waits until its error is within stopError (inches, or degrees for turns), then stops it
+    // ex: drive until 1 ft from the target or 2 seconds pass
+    //      withTimeout(motionWithin([]{ return base.moveToAsync(6_ft, 6_ft); }, 1_ft), 2000)
+    CommandPtr motionWithin(std::function<Drivetrain::MotionHandle()> startMotion, scalar_t stopError);
+    // requests a lift state with setState and waits for the lift to settle
+    CommandPtr liftTo(std::function<void()> setState);
+
+    // runs commands one after another
+    CommandPtr sequence(std::initializer_list<CommandPtr> commands);
+    // runs commands at the same time until all have finished
+    CommandPtr parallel(std::initializer_list<CommandPtr> commands);
+    // runs commands at the same time until any has finished
+    CommandPtr race(std::initializer_list<CommandPtr> commands);
+    // runs deadline and commands at the same time until deadline has finished
+    CommandPtr deadline(const CommandPtr& deadline, std::initializer_list<CommandPtr> commands);
+    // runs command until it finishes or time milliseconds pass
+    CommandPtr withTimeout(const CommandPtr& command, uint32_t time);
+
+} // namespace commands
+
+#endif
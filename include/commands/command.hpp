@@ -0,0 +1,173 @@
+#ifndef _COMMAND_HPP_
+#define _COMMAND_HPP_
+
+#include "drivetrain.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+
+/**
+ * This file contains the declaration of Command, the unit of work run by CommandScheduler, and the basic commands
+ *
+ * A command is initialized once, executed every scheduler tick (10 ms) until it is finished, then ended
+ * Commands declare the subsystems they require; scheduling a command interrupts the running commands that require
+ * any of the same subsystems, so two commands never control a subsystem at once
+ *
+ * Commands must not block: waiting is done by returning false from isFinished
+ * Behaviors without a command class of their own can be written as a FunctionalCommand
+ * Drivetrain motions are queued to the drive task (the Async movement functions) and monitored through their MotionHandle
+ */
+
+namespace commands {
+
+    // subsystems a command can require
+    enum class Subsystem : uint8_t {
+        drivetrain  = 1 << 0,
+        lift        = 1 << 1,
+        intake      = 1 << 2,
+        holder      = 1 << 3
+    };
+
+    // set of subsystems, one bit per Subsystem
+    using Requirements = uint8_t;
+
+    class Command {
+    public:
+
+        // constructor, subsystems are the subsystems the command controls
+        explicit Command(std::initializer_list<Subsystem> subsystems = {});
+        virtual ~Command() = default;
+
+        // called once when the command is scheduled
+        virtual void initialize();
+        // called every scheduler tick while the command runs
+        virtual void execute();
+        // returns true once the command is done, checked every scheduler tick after execute
+        virtual bool isFinished() = 0;
+        // called once when the command finishes or is interrupted (cancelled, or replaced by a command with a shared requirement)
+        virtual void end(bool interrupted);
+
+        // returns the subsystems the command controls
+        Requirements getRequirements() const;
+
+    protected:
+
+        Requirements requirements;
+
+    };
+
+    // commands are shared between groups and the scheduler
+    using CommandPtr = std::shared_ptr<Command>;
+
+    // runs a function once and finishes immediately
+    class InstantCommand final : public Command {
+    public:
+
+        InstantCommand(std::function<void()> action, std::initializer_list<Subsystem> subsystems = {});
+
+        void initialize() override;
+        bool isFinished() override;
+
+    private:
+
+        std::function<void()> action;
+
+    };
+
+    // finishes once time milliseconds have passed since it was initialized
+    class WaitCommand final : public Command {
+    public:
+
+        explicit WaitCommand(uint32_t time);
+
+        void initialize() override;
+        bool isFinished() override;
+
+    private:
+
+        uint32_t time;
+        uint32_t startTime {0};
+
+    };
+
+    // finishes once condition returns true
+    class WaitUntilCommand final : public Command {
+    public:
+
+        explicit WaitUntilCommand(std::function<bool()> condition);
+
+        bool isFinished() override;
+
+    private:
+
+        std::function<bool()> condition;
+
+    };
+
+    // runs the given functions as the respective Command functions, with empty functions doing nothing
+    // ex: spin the intake until a sensor sees a ring
+    //      FunctionalCommand({}, []{ intake.intake(); }, []{ return ringDetected(); }, [](bool){ intake.stop(); }, {Subsystem::intake})
+    class FunctionalCommand final : public Command {
+    public:
+
+        FunctionalCommand(
+            std::function<void()> onInitialize, std::function<void()> onExecute,
+            std::function<bool()> onIsFinished, std::function<void(bool)> onEnd,
+            std::initializer_list<Subsystem> subsystems = {}
+        );
+
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+
+    private:
+
+        std::function<void()> onInitialize;
+        std::function<void()> onExecute;
+        std::function<bool()> onIsFinished;
+        std::function<void(bool)> onEnd;
+
+    };
+
+    // queues a Drivetrain motion (startMotion calls an Async movement function) and finishes when the motion does
+    // if stopError is given, the command also finishes (stopping the motion) once the motion's error is within stopError
+    // the motion is cancelled if the command is interrupted
+    class MotionCommand final : public Command {
+    public:
+
+        explicit MotionCommand(std::function<Drivetrain::MotionHandle()> startMotion, scalar_t stopError = NAN);
+
+        void initialize() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+
+    private:
+
+        std::function<Drivetrain::MotionHandle()> startMotion;
+        // inches, or degrees during turns, NAN to run the motion to completion
+        scalar_t stopError;
+        Drivetrain::MotionHandle handle;
+
+    };
+
+    // requests a lift state (setState calls raise, lower, setSubposition, ...) and finishes when the lift has settled there
+    class LiftCommand final : public Command {
+    public:
+
+        explicit LiftCommand(std::function<void()> setState);
+
+        void initialize() override;
+        bool isFinished() override;
+
+    private:
+
+        std::function<void()> setState;
+
+    };
+
+} // namespace commands
+
+#endif
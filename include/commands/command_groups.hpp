@@ -0,0 +1,69 @@
+#ifndef _COMMAND_GROUPS_HPP_
+#define _COMMAND_GROUPS_HPP_
+
+#include "commands/command.hpp"
+
+#include <vector>
+
+/**
+ * This file contains the declarations of the command groups, commands that run other commands
+ *
+ * A group requires every subsystem its commands require
+ *      SequentialGroup runs its commands one after another
+ *      ParallelGroup runs its commands at the same time, and finishes when
+ *          all of them have finished (all), any of them has finished (race), or the first of them has finished (deadline)
+ *          commands still running when the group finishes are interrupted
+ *
+ * Commands in a ParallelGroup should not require the same subsystems, as they would control them at once
+ * A command should only be in one group, and should not be scheduled on its own while its group runs
+ */
+
+namespace commands {
+
+    class SequentialGroup final : public Command {
+    public:
+
+        explicit SequentialGroup(std::initializer_list<CommandPtr> commands);
+
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+
+    private:
+
+        std::vector<CommandPtr> commands;
+        // index of the running command, commands.size() once every command has finished
+        size_t current {0};
+
+    };
+
+    class ParallelGroup final : public Command {
+    public:
+
+        // when the group finishes
+        enum class Mode {
+            all,        // every command has finished
+            race,       // any command has finished
+            deadline    // the first command has finished
+        };
+
+        ParallelGroup(Mode mode, std::initializer_list<CommandPtr> commands);
+
+        void initialize() override;
+        void execute() override;
+        bool isFinished() override;
+        void end(bool interrupted) override;
+
+    private:
+
+        Mode mode;
+        std::vector<CommandPtr> commands;
+        // whether each command is still running
+        std::vector<bool> running;
+
+    };
+
+} // namespace commands
+
+#endif
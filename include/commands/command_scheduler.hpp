@@ -0,0 +1,49 @@
+#ifndef _COMMAND_SCHEDULER_HPP_
+#define _COMMAND_SCHEDULER_HPP_
+
+#include "commands/command.hpp"
+
+#include <vector>
+
+/**
+ * This file contains the declaration of the static CommandScheduler class
+ *
+ * CommandScheduler runs every scheduled command in one loop: each tick (10 ms) the running commands are executed
+ * in the order they were scheduled, and finished commands are ended, so the same auton runs the same way every time
+ *
+ * Only use CommandScheduler from one task (the auton task), it is not protected by a mutex
+ */
+
+namespace commands {
+
+    class CommandScheduler final {
+    public:
+
+        // time (milliseconds) between scheduler ticks
+        static constexpr uint32_t period = 10;
+
+        // Initializes command and runs it every tick until it finishes
+        // Running commands that require any of the same subsystems are interrupted
+        static void schedule(const CommandPtr& command);
+        // Interrupts command if it is running
+        static void cancel(const CommandPtr& command);
+        // Interrupts every running command
+        static void cancelAll();
+        // Returns true if command is running
+        static bool isScheduled(const CommandPtr& command);
+
+        // Runs one tick: executes every running command, then ends the commands that have finished
+        static void run();
+        // Schedules command, then runs ticks every period until it finishes, other scheduled commands keep running
+        static void runUntilFinished(const CommandPtr& command);
+
+    private:
+
+        // running commands, in the order they were scheduled
+        static std::vector<CommandPtr> commands;
+
+    };
+
+} // namespace commands
+
+#endif
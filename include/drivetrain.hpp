@@ -1,9 +1,13 @@
 #ifndef _DRIVETRAIN_HPP_
 #define _DRIVETRAIN_HPP_
 
+#include "util/cached_motor.hpp"
 #include "util/pid_controller.hpp"
 #include "api.h"
 #include "macros.h"
+#include "sensor_hub.hpp"
+
+#include <atomic>
 
 /**
  * Declaration for the Drivetrain class and the drive namespace
@@ -14,7 +18,8 @@
  * An instance of Drivetrain, base, is found in the drive namespace
  *
  * Drivetrain implements several algorithms to ensure accurate and efficient autonomous movement:
- *      Odometry: tracks position for mid motion error correction, is always running
+ *      Odometry: tracks position for mid motion error correction, is always running,
+ *          an extended Kalman filter fuses the tracking wheels, drive motor encoders, and both IMUs
  *      Pure Pursuit: smooths motions when transversing several Waypoint
  *      Motion Profiling: a feedforward algorithm to maximize efficiency, uses feedback for additional error correction
  *
@@ -51,17 +56,85 @@ public:
     class Path;
 
     /**
-     * Function signatures for exit conditions
+     * Polyline data storage for pure pursuit
+     */
+
+    class PurePursuitPath;
+
+    /**
+     * Determines look ahead distances for pure pursuit and motion profile error correction
+     */
+
+    struct LookAheadPolicy;
+
+    /**
+     * Handle to a motion executed asynchronously by the drive task
+     */
+
+    class MotionHandle;
+
+    /**
+     * Extended Kalman filter used by odometry, and the uncertainty of its estimate
+     */
+
+    class PoseEstimator;
+    struct PoseCovariance;
+    struct Kinematics;
+    struct DistanceSensorMount;
+
+    /**
+     * Monte Carlo localizer used to correct odometry during long runs
+     */
+
+    class ParticleFilter;
+
+    /**
+     * Timestamped poses recorded by odometry, used to look up past positions
+     */
+
+    class PoseHistory;
+
+    /**
+     * Sensors the tracking wheels are mounted on (ADI encoders or Rotation sensors)
+     */
+
+    class TrackingWheels;
+    class ADITrackingWheels;
+    class RotationTrackingWheels;
+
+    /**
+     * Thermal and current limits of the drive motors
      */
 
-    typedef bool (*PurePursuitExitConditions)(long double, long double, bool);
-    typedef bool (*LinearExitConditions)(long double, bool, bool);
-    typedef bool (*TurnExitConditions)(bool, bool);
+    class PowerManager;
 
-    // includes templated (with default template arguments) default exit condition functions
+    // states a motion executed by the drive task can be in
+    enum class MotionStatus {
+        queued,     // waiting in the motion queue for previous motions to finish
+        running,    // currently being executed by the drive task
+        completed,  // finished normally (exit conditions or stopMotion)
+        cancelled,  // cancelled before or during execution
+        rejected    // could not be queued (the motion queue was full), the motion will never run
+    };
+
+    /**
+     * Exit conditions for movements
+     */
+
+    // includes the ExitConditions class and factory functions for the default exit conditions
     // In a separate file to save space / readability in this one
 #include "drivetrain/exit_conditions.hpp"
 
+    // each motion takes its own copy of the exit conditions
+    using PurePursuitExitConditions = ExitConditions;
+    using LinearExitConditions = ExitConditions;
+    using TurnExitConditions = ExitConditions;
+
+    // exit conditions used when none are specified, defined in src/drivetrain/constants.cpp
+    static const ExitConditions defaultPurePursuitExit;
+    static const ExitConditions defaultLinearExit;
+    static const ExitConditions defaultTurnExit;
+
     // Blocks task until the Drivetrain IMU is calibrated (odom can start running)
     static void waitUntilCalibrated();
 
@@ -80,9 +153,37 @@ public:
     static Point getPosition();
     // Sets the tracked position (use to tell the Drivetrain where it is)
     // MUTEX LOCKING
-    static void setPosition(long double newX, long double newY, long double newHeading);
+    static void setPosition(scalar_t newX, scalar_t newY, scalar_t newHeading);
+    // Returns the covariance of the tracked position, use to decide when the position should be corrected
+    // MUTEX LOCKING
+    static PoseCovariance getPoseCovariance();
+    // Returns the standard deviation (inches) of the distance between the tracked and true positions
+    // MUTEX LOCKING
+    static scalar_t getPositionUncertainty();
+    // Returns the tracked velocities and accelerations
+    // MUTEX LOCKING
+    static Kinematics getKinematics();
+    // Enables or disables correcting the tracked position against the field walls with the distance sensors (disabled by default)
+    // Corrections are made by odometry mid motion, enable while the sensors face walls that are mostly unobstructed
+    // MUTEX LOCKING
+    static void setRelocalization(bool enabled);
+    // Enables or disables correcting the tracked position with the particle filter (disabled by default)
+    // The particle filter uses the distance sensors (in place of setRelocalization) and the GPS,
+    // and is restarted around the tracked position when enabled
+    // MUTEX LOCKING
+    static void setParticleLocalization(bool enabled);
+    // Returns the tracked position at time (microseconds, from pros::micros), interpolated between odometry updates
+    // Use to apply sensor readings at the time they were captured, only the last 512 odometry updates are stored
+    // Returns a Point of NAN if time is not stored, does not lock the mutex
+    static Point getPositionAt(uint64_t time);
+    // Writes the stored position history as csv (time in microseconds, x, y, heading) to file, does not lock the mutex
+    static void writePositionHistory(FILE* file = stdout);
+    // Returns the fraction of full voltage the drive motors can currently supply (thermal and current limits),
+    // motion profiles scale their max velocity and acceleration by it, does not lock the mutex
+    static scalar_t getAvailablePower();
 
     // Supply power to the Drivetrain motors [-127, 127] and [-12000, 12000] for the respective functions
+    // the power is split between the motors within their thermal and current limits (see drivetrain/power_manager.hpp)
     // Forward and clockwise (due to controller joystick notation) are positive
     static void supply(int linearPow, int rotPow);
     static void supplyVoltage(int linearPow, int rotPow);
@@ -101,6 +202,9 @@ public:
     // Uses pure pursuit to move towards the Waypoint; for optimal use utilize several pure pursuit movements in succession
     // MUTEX LOCKING
     Drivetrain& operator<<(const Waypoint& p);
+    // Uses pure pursuit to follow the polyline stored in the PurePursuitPath
+    // MUTEX LOCKING
+    Drivetrain& operator<<(const PurePursuitPath& path);
     // Invokes moveTo to move to the Point
     // MUTEX LOCKING
     Drivetrain& operator>>(Point p);
@@ -108,22 +212,22 @@ public:
     // If heading is a number (is specified), will invoke turnTo after reaching the desired position
     // MUTEX LOCKING
     static void moveTo(
-        long double x, long double y, long double heading = NAN,
+        scalar_t x, scalar_t y, scalar_t heading = NAN,
         LinearExitConditions linearExitConditions = defaultLinearExit, TurnExitConditions turnExitConditions = defaultTurnExit
     );
     // Will turn to face targetForHeading using absolute coordinates after reaching the desired position
     // MUTEX LOCKING
     static void moveTo(
-        long double x, long double y, XYPoint targetForHeading,
+        scalar_t x, scalar_t y, XYPoint targetForHeading,
         LinearExitConditions linearExitConditions = defaultLinearExit, TurnExitConditions turnExitConditions = defaultTurnExit
     );
     // Will move to the desired position
     // MUTEX LOCKING
-    static void moveTo(long double x, long double y, LinearExitConditions linearExitConditions);
+    static void moveTo(scalar_t x, scalar_t y, LinearExitConditions linearExitConditions);
 
     // Will turn to the desired heading
     // MUTEX LOCKING
-    static void turnTo(long double heading, TurnExitConditions exitConditions = defaultTurnExit);
+    static void turnTo(scalar_t heading, TurnExitConditions exitConditions = defaultTurnExit);
     // Will turn to face target using the system specified by the bool absolute
     // MUTEX LOCKING
     static void turnTo(XYPoint target, bool absolute = false, TurnExitConditions exitConditions = defaultTurnExit);
@@ -131,14 +235,64 @@ public:
     // Moves forward, uses the system specified by the bool absolute to determine the desired final position
     // Does not invoke turnTo after the movement is complete
     // MUTEX LOCKING
-    static void moveForward(long double dist, bool absolute = true, LinearExitConditions exitConditions = defaultLinearExit);
+    static void moveForward(scalar_t dist, bool absolute = true, LinearExitConditions exitConditions = defaultLinearExit);
 
     /**
      * End of movement functions
      */
+
+    /**
+     * Asynchronous movement functions
+     *
+     * These queue the respective movement to be executed by the drive task and return immediately
+     * Motions in the queue are executed in order, the returned MotionHandle can be used to wait on, poll, or cancel the motion
+     *
+     * Actions added (addAction, withAction, endEarly, ...) before the call are bound to the queued motion
+     * Speed limits are read while the motion runs, the follow direction is read when the motion starts
+     * Do not call the blocking movement functions while queued motions are running
+     */
+
+    // MUTEX LOCKING
+    static MotionHandle moveToAsync(
+        scalar_t x, scalar_t y, scalar_t heading = NAN,
+        LinearExitConditions linearExitConditions = defaultLinearExit, TurnExitConditions turnExitConditions = defaultTurnExit
+    );
+    // MUTEX LOCKING
+    static MotionHandle moveToAsync(
+        scalar_t x, scalar_t y, XYPoint targetForHeading,
+        LinearExitConditions linearExitConditions = defaultLinearExit, TurnExitConditions turnExitConditions = defaultTurnExit
+    );
+    // MUTEX LOCKING
+    static MotionHandle moveToAsync(scalar_t x, scalar_t y, LinearExitConditions linearExitConditions);
+    // MUTEX LOCKING
+    static MotionHandle turnToAsync(scalar_t heading, TurnExitConditions exitConditions = defaultTurnExit);
+    // MUTEX LOCKING
+    static MotionHandle turnToAsync(XYPoint target, bool absolute = false, TurnExitConditions exitConditions = defaultTurnExit);
+    // MUTEX LOCKING
+    static MotionHandle moveForwardAsync(scalar_t dist, bool absolute = true, LinearExitConditions exitConditions = defaultLinearExit);
+    // Queues a pure pursuit movement to the Waypoint
+    // MUTEX LOCKING
+    static MotionHandle followAsync(const Waypoint& p);
+    // Queues a pure pursuit movement along the PurePursuitPath
+    // MUTEX LOCKING
+    static MotionHandle followAsync(const PurePursuitPath& path);
+    // Queues following the motion profile stored in the Path
+    // MUTEX LOCKING
+    static MotionHandle followAsync(Path&& path);
+    // Queues an arbitrary sequence of blocking movement calls to be executed as one motion
+    // ex: base.runAsync([]{ base << Waypoint {3_ft, 2.5_ft} << endAt(9_ft, 3_ft); });
+    // MUTEX LOCKING
+    static MotionHandle runAsync(std::function<void()>&& motion);
+
+    // Blocks the calling task until every queued motion has finished
+    // MUTEX LOCKING
+    static void waitUntilSettled();
+    // Cancels the running motion and every queued motion
+    // MUTEX LOCKING
+    static void cancelAllMotions();
     
     // Store an action to be executed during the next movement at the given error
-    static void addAction(std::function<void()>&& action, double dist, bool duringTurn = false);
+    static void addAction(std::function<void()>&& action, scalar_t dist, bool duringTurn = false);
 
     // Stops a motion early when called during that motion (pass stopMotion to addAction)
     static void stopMotion();
@@ -152,8 +306,8 @@ public:
      */
     
     // Limits linear and turn speeds
-    static void limitSpeed(long double speed);
-    static void limitLinearSpeed(long double speed);
+    static void limitSpeed(scalar_t speed);
+    static void limitLinearSpeed(scalar_t speed);
     // voltage is in millivolts (out of 12000)
     static void limitTurnSpeed(int voltage);
     // Unbounds linear and turn speeds
@@ -161,13 +315,19 @@ public:
     static void unboundLinearSpeed();
     static void unboundTurnSpeed();
     // The max speed of the bot in inches per second
-    static const long double maxVelocity;
+    static const scalar_t maxVelocity;
     
     // When called between motions, sets the starting voltage of the linearPID slew controller during the next motion
     static void setLinearSlew(int slewPower);
 
     // Allows mainTasks to calibrate IMU, reset tracking wheel encoders, mark when calibration is complete, and run odometry
     friend void mainTasks(void*);
+    // Allows odometryTasks to run odometry (when it runs faster than mainTasks)
+    friend void odometryTasks(void*);
+    // Allows driveTasks to execute queued motions
+    friend void driveTasks(void*);
+    // Allows SensorHub to sample the Drivetrain devices
+    friend class SensorHub;
 
 private:
 
@@ -175,39 +335,65 @@ private:
     struct Action final {
 
         // constructor
-        Action(std::function<void()>&& newAction, double atError, bool duringTurn = false);
+        Action(std::function<void()>&& newAction, scalar_t atError, bool duringTurn = false);
 
         // action to execute
         std::function<void()> action;
         // error at which to execute the action
-        double error;
+        scalar_t error;
         // execute during a linear movement or turn (needed for moveTo commands which invoke turnTo)
         bool duringTurn;
 
     };
 
+    // State shared between a MotionHandle and the motion queue, protected by motionQueueMutex
+    struct MotionState final {
+        MotionStatus status {MotionStatus::queued};
+        // remaining error as of the last control loop of the motion
+        scalar_t error   {NAN};
+    };
+
+    // Struct to store a motion queued by the asynchronous movement functions
+    struct MotionCommand final {
+
+        // the blocking movement call(s) to execute
+        std::function<void()> motion;
+        // actions bound to the motion when it was queued
+        std::vector<Action> actions;
+        // state shared with the MotionHandle returned to the caller
+        std::shared_ptr<MotionState> state;
+        // true if the motion only drives to a point (no turn at the end), so it can be blended with adjacent such motions
+        bool blendable;
+
+    };
+
     /**
      * Devices
      *
      * All devices are instantiated in src/devices.cpp
      */
 
-    /* motors: used in field control tasks */
+    /* motors: used in field control tasks, repeated commands are not sent (see util/cached_motor.hpp) */
 
-    static pros::Motor frontLeftMotor;
-    static pros::Motor topBackLeftMotor;
-    static pros::Motor bottomBackLeftMotor;
-    static pros::Motor frontRightMotor;
-    static pros::Motor topBackRightMotor;
-    static pros::Motor bottomBackRightMotor;
+    static motor_control::CachedMotor frontLeftMotor;
+    static motor_control::CachedMotor topBackLeftMotor;
+    static motor_control::CachedMotor bottomBackLeftMotor;
+    static motor_control::CachedMotor frontRightMotor;
+    static motor_control::CachedMotor topBackRightMotor;
+    static motor_control::CachedMotor bottomBackRightMotor;
 
     /* sensors: used in main tasks */
 
     static pros::Imu imu1;
     static pros::Imu imu2;
 
-    static pros::ADIEncoder parallelTrackingWheel;
-    static pros::ADIEncoder perpendicularTrackingWheel;
+    // selected with ROTATION_SENSOR_ODOMETRY (include/macros.h)
+    static TrackingWheels& trackingWheels;
+
+    static pros::Distance leftDistanceSensor;
+    static pros::Distance backDistanceSensor;
+
+    static pros::Gps gps;
 
     // Mutex: protects positional data, instantiated in src/drivetrain/drivetrain.cpp
     static pros::Mutex positionDataMutex;
@@ -221,20 +407,40 @@ private:
     /* current position: used in field control and main tasks */
 
     // NEEDS MUTEX COVER
-    static long double xPos;
+    static scalar_t xPos;
+    // NEEDS MUTEX COVER
+    static scalar_t yPos;
+    // NEEDS MUTEX COVER
+    static scalar_t heading;
+    // fuses the Drivetrain sensors to determine the current position, instantiated in src/drivetrain/drivetrain.cpp
+    // NEEDS MUTEX COVER
+    static PoseEstimator poseEstimator;
+    // velocities and accelerations published by odometry
+    // NEEDS MUTEX COVER
+    static Kinematics kinematics;
+    // whether odometry corrects the position against the field walls with the distance sensors
+    // NEEDS MUTEX COVER
+    static bool relocalizationEnabled;
+    // Monte Carlo localizer, corrects poseEstimator once its particles agree, instantiated in src/drivetrain/drivetrain.cpp
     // NEEDS MUTEX COVER
-    static long double yPos;
+    static ParticleFilter particleFilter;
+    // whether odometry runs the particle filter
     // NEEDS MUTEX COVER
-    static long double heading;
+    static bool particleLocalizationEnabled;
+    // positions recorded by odometry, written in main task and read without the mutex (see PoseHistory)
+    static PoseHistory poseHistory;
+    // limits the drive motor voltages, updated in the sensor task (SensorHub::sample) and used by the tasks supplying power
+    // to the Drivetrain through the atomic available power (see PowerManager)
+    static PowerManager powerManager;
 
     /* old targeted position: used in main task */
 
     // Used to implement segmented pure pursuit
-    static long double oldTargetX;
+    static scalar_t oldTargetX;
     // Used to implement segmented pure pursuit
-    static long double oldTargetY;
+    static scalar_t oldTargetY;
     // Used to keep a consistent heading between motions (that may not specify a target heading)
-    static long double targetHeading;
+    static scalar_t targetHeading;
 
     /**
      * PID Controllers
@@ -263,7 +469,8 @@ private:
     static bool driveReversed;
 
     // state variable used to end motions early
-    static bool stopped;
+    // atomic, as motions are cancelled from other tasks while the drive task reads it in its control loop
+    static std::atomic<bool> stopped;
 
     /**
      * Constants
@@ -271,16 +478,49 @@ private:
      * Instantiated in src/drivetrain/constants.cpp
      */
 
-    // Used to implement pure pursuit, used in field control tasks
-    static const long double defaultLookAheadDistance;
+    // Used to implement pure pursuit and motion profile error correction, used in field control tasks
+    static const LookAheadPolicy defaultLookAheadPolicy;
     // Used to implement non linear moveTo functionality, used in field control tasks
-    static const long double minDistForTurning;
+    static const scalar_t minDistForTurning;
+    // Distance from the target at which a blended moveTo hands off to the next queued motion, used in drive task
+    static const scalar_t blendDistance;
 
     /* odometry constants: used in main task */
 
-    static const long double wheelSpacingParallel;
-    static const long double wheelSpacingPerpendicular;
-    static const long double trackingWheelDiameter;
+    static const scalar_t wheelSpacingParallel;
+    static const scalar_t wheelSpacingPerpendicular;
+    static const scalar_t trackingWheelDiameter;
+    static const scalar_t driveWheelDiameter;
+    // drive wheel rotations per motor rotation
+    static const scalar_t driveGearRatio;
+    // length of the sides of the field, the walls are the lines x = 0, y = 0, x = fieldLength, and y = fieldLength
+    static const scalar_t fieldLength;
+    // radians, direction of the GPS x axis on the field, counterclockwise from the field x axis
+    // the GPS measures from the center of the field along axes set by the field code strips, which need not match ours
+    static const scalar_t gpsFieldRotation;
+    // where the distance sensors are mounted
+    static const DistanceSensorMount leftDistanceSensorMount;
+    static const DistanceSensorMount backDistanceSensorMount;
+    // time (milliseconds) between distance sensor corrections
+    static const uint32_t relocalizationPeriod;
+    // in and radians, standard deviations of the particles around the tracked position when the particle filter is restarted
+    static const scalar_t initialParticleSpread;
+    static const scalar_t initialParticleHeadingSpread;
+    // in, the particle filter only corrects poseEstimator once its spread is under maxParticleSpread,
+    // spreads under minParticleSpread are treated as minParticleSpread (the particles can collapse after resampling)
+    static const scalar_t maxParticleSpread;
+    static const scalar_t minParticleSpread;
+    // the particle filter reuses the odometry readings, so its variance is scaled up by this before correcting poseEstimator
+    static const scalar_t particleVarianceInflation;
+    // time constant (seconds) of the low pass filter on the published accelerations
+    static const scalar_t accelerationFilterTime;
+    // temperatures (degrees C) drive motor derating starts at, and reaches driveMinVoltageFraction at
+    static const scalar_t driveDerateStartTemperature;
+    static const scalar_t driveDerateEndTemperature;
+    static const scalar_t driveMinVoltageFraction;
+    // current (mA) a drive motor can draw indefinitely, and the time constant (seconds) of the current filter
+    static const scalar_t driveSustainedCurrent;
+    static const scalar_t driveCurrentFilterTime;
 
     // current max voltages to supply as linear and turn components of movements, units are millivolts
     static int linearSpeedLimit;
@@ -288,60 +528,126 @@ private:
 
     /* motion profiling constants: used in field control tasks */
 
-    static const long double maxAcceleration;
-    static const long double drivetrainWidth;
+    static const scalar_t maxAcceleration;
+    static const scalar_t drivetrainWidth;
     // Time step used when generating a profile, should equal the time delay used in the loop that runs the profile
-    static const long double profileDT;
+    static const scalar_t profileDT;
 
-    // Storage for actions to execute mid motion: used in field control tasks
+    // Storage for actions to execute mid motion: used by the task executing the motion
     static std::vector<Action> actionList;
 
+    /**
+     * Motion queue
+     *
+     * Instantiated in src/drivetrain/async.cpp
+     */
+
+    // Mutex: protects queuedActions, the motion queue, and MotionHandle states
+    static pros::Mutex motionQueueMutex;
+
+    // Storage for actions added between motions, moved into actionList (or a MotionCommand) when the next motion starts
+    // NEEDS MUTEX COVER: used in field control and drive tasks
+    static std::vector<Action> queuedActions;
+
+    // Max number of motions that can be waiting in the queue
+    static constexpr size_t motionQueueCapacity = 16;
+    // Ring buffer of queued motions
+    // NEEDS MUTEX COVER: used in field control and drive tasks
+    static MotionCommand motionQueue[motionQueueCapacity];
+    static size_t motionQueueStart;
+    static size_t motionQueueLength;
+
+    // State of the motion currently being executed by the drive task, nullptr if none
+    // NEEDS MUTEX COVER: used in field control and drive tasks
+    static std::shared_ptr<MotionState> currentMotion;
+    // true while the drive task is executing a queued motion, actions are already bound so queuedActions are left alone
+    static bool runningQueuedMotion;
+
+    /* motion blending: used in drive task */
+
+    // true if the running motion should hand off to the next queued motion without stopping
+    // (exits within blendDistance, does not zero the motors)
+    // NEEDS MUTEX COVER: cleared when the motion is cancelled
+    static bool blendingOut;
+    // true if the running motion continues from a blended motion (PID state is carried over rather than reset)
+    static bool blendingIn;
+
     /**
      * Private movement functions
      *
      * Used in field control tasks
      */
 
+    // Resets stopped, moves queued actions into actionList, updates the speeds PID gains are scheduled by,
+    // call at the start of every movement
+    // MUTEX LOCKING
+    static void startMotion();
+
+    // Stores an action for the next motion: in actionList if called by the drive task (which executes the motion),
+    // otherwise in queuedActions
+    // MUTEX LOCKING
+    static void storeAction(Action&& action);
+
+    // Adds a motion to the motion queue, binds queued actions to it, and notifies the drive task
+    // MUTEX LOCKING
+    // blendable should be true if the motion only drives to a point (see MotionCommand)
+    // MUTEX LOCKING
+    static MotionHandle queueMotion(std::function<void()>&& motion, bool blendable = false);
+    // Returns true if the running motion should hand off to the next queued motion without stopping
+    // MUTEX LOCKING
+    static bool blendIntoNextMotion();
+    // Executes motions in the queue until it is empty, called in drive task
+    // MUTEX LOCKING
+    static void runQueuedMotions();
+
     // Updates driveReversed, call if autoDetermineReversed
-    static void determineFollowDirection(long double xTarget, long double yTarget);
+    static void determineFollowDirection(scalar_t xTarget, scalar_t yTarget);
 
-    // Converts encoder rotations to inches traveled
-    static long double ticksToInches(int ticks);
+    // Converts drive motor rotation (degrees) to inches traveled
+    static scalar_t motorDegreesToInches(scalar_t degrees);
 
     // Executes actions stored in actionList if they are eligible to be executed
-    static void executeActions(double currError, bool inTurn = false);
+    static void executeActions(scalar_t currError, bool inTurn = false);
+    // Executes the actions in actionList (not bound to turns) that have not been executed,
+    // called when a blended motion hands off before reaching the errors of its remaining actions
+    static void executeRemainingActions();
 
-    // Sets motor power to 0, clears actionList
+    // Sets motor power to 0 (unless blending into the next motion), clears actionList
     static void endMotion();
-    // Sets motor power to 0, updates old target variables, clears actionList
-    static void endMotion(long double targetX, long double targetY);
+    // Sets motor power to 0 (unless blending into the next motion), updates old target variables, clears actionList
+    static void endMotion(scalar_t targetX, scalar_t targetY);
 
     // Wraps the heading based off of targetAngle to minimize the distance between the two
     // NEEDS MUTEX COVER: accesses positional data
-    static long double wrapAngle(long double targetAngle);
+    static scalar_t wrapAngle(scalar_t targetAngle);
     // Wraps the targetHeading based off of targetAngle to minimize the distance between the two
-    static long double wrapTargetHeading(long double targetAngle);
-
-    // Returns 1 if positive or 0, -1 if negative
-    static int sign(long double num);
+    static scalar_t wrapTargetHeading(scalar_t targetAngle);
 
-    // Returns the point for the movement algorithm to target, as determined by pure pursuit
-    // NEEDS MUTEX COVER: accesses positional data
-    static XYPoint purePursuitLookAhead(
-        long double lookAheadDistance,
-        XYPoint newEndpoint
-    );
+    // Follows the path using pure pursuit, tracking progress along the path
+    // MUTEX LOCKING
+    static void followPurePursuit(PurePursuitPath& path);
 
     // Carry out one step of odometry calculations, called in main task
     // NEEDS MUTEX COVER: accesses positional data
     static void trackPosition();
+    // Moves and weights the particles with the sensor readings, then corrects poseEstimator, called in trackPosition
+    // NEEDS MUTEX COVER: accesses positional data
+    static void updateParticleFilter(const SensorHub::Snapshot& snapshot);
 
 };
 
 // includes Drivetrain::Point and Drivetrain::Path classes
 // In separate files to save space / readability in this one
+#include "drivetrain/look_ahead_policy.hpp"
 #include "drivetrain/point.hpp"
 #include "drivetrain/path.hpp"
+#include "drivetrain/pure_pursuit_path.hpp"
+#include "drivetrain/motion_handle.hpp"
+#include "drivetrain/pose_estimator.hpp"
+#include "drivetrain/particle_filter.hpp"
+#include "drivetrain/pose_history.hpp"
+#include "drivetrain/tracking_wheels.hpp"
+#include "drivetrain/power_manager.hpp"
 
 // namespace drive and using statements is an easy way to bring Drivetrain classes and methods into the current namespace
 namespace drive {
@@ -354,9 +660,18 @@ namespace drive {
     using Waypoint  = Drivetrain::Waypoint;
 
     using Path = Drivetrain::Path;
+    using PurePursuitPath = Drivetrain::PurePursuitPath;
+    using LookAheadPolicy = Drivetrain::LookAheadPolicy;
+
+    using MotionHandle = Drivetrain::MotionHandle;
+
+    using PoseCovariance = Drivetrain::PoseCovariance;
+    using Kinematics = Drivetrain::Kinematics;
+    using DistanceSensorMount = Drivetrain::DistanceSensorMount;
 
     using Direction = Drivetrain::Direction;
 
+    using ExitConditions = Drivetrain::ExitConditions;
     using PurePursuitExitConditions = Drivetrain::PurePursuitExitConditions;
     using LinearExitConditions = Drivetrain::LinearExitConditions;
     using TurnExitConditions = Drivetrain::TurnExitConditions;
@@ -3,170 +3,131 @@
 #define _EXIT_CONDITIONS_HPP_
 
 /**
- * Separate file to define default exit condition functions
+ * Separate file for the Drivetrain::ExitConditions declaration
  * included in the Drivetrain class in drivetrain.hpp
  *
- * Functions take a reset parameter to determine whether to reset static variables
+ * ExitConditions determines when a motion has finished, it is composed of optional checks:
+ *      Tolerance: exit once the error (and velocity) stays within tolerance for the settle time
+ *      Stuck detection: exit once the velocity stays below a threshold for the stuck time, regardless of error
+ *      Timeout: exit once the motion has run for the timeout
+ *      Look ahead: exit once the error is within the look ahead distance (pure pursuit)
+ *      Predicate: exit once a user supplied function returns true
+ *
+ * Every check is evaluated once per control loop (10 ms), times are rounded down to multiples of 10 ms
+ * Counters tolerate brief velocity noise (noiseLoops control loops) before resetting
+ *
+ * All state is stored in the object and no memory is allocated, so ExitConditions can be freely copied
+ * Movement functions take ExitConditions by value and reset their copy, so motions never share state
  */
 
-/**
- * Exit Condition template for pure pursuit motions
- * Pass args * 1000 as template arguments
- */
+class ExitConditions final {
+public:
 
-template <
-    long derivativeStuckThreshold = 500,
-    long maxTimeStuck = 1500
->
-static bool defaultPurePursuitExit(long double curDist, long double lookAheadDist, bool reset) {
-    // track time stuck 
-    static uint16_t count       = 0;
-    static uint32_t noiseCount  = 0;
-    if (reset) {
-        count = 0;
-        noiseCount = 0;
-        return false;
-    }
-    if (curDist <= lookAheadDist) {
-        return true; // exit if within look ahead distance of target
-    } else if (linearPID.getDerivative() <= derivativeStuckThreshold / 1000.0) {
-        ++count; // increment time stuck
-        count += noiseCount; // increment by time where derivative noise disrupted the exit conditions
-        noiseCount = 0; // derivative noise is not currently significant enough to wrongfully stop exit
-        if (count >= maxTimeStuck / 10) {
-            return true; // exit if stuck
-        }
-    } else if (count > 0) {
-        ++noiseCount; // account for derivative noise
-        if (noiseCount >= 5) { // if derivative is likely indeed outside acceptable thresholds, reset the counts
-            count = 0;
-            noiseCount = 0;
-        }
-    }
-    return false; // not close enough to target / did not time out
-}
+    // state of the motion during one control loop, passed to the exit conditions by the movement functions
+    struct Sample {
+        scalar_t error;              // remaining error (inches, or degrees during turns), negative past the target
+        scalar_t rotError;           // remaining heading error (degrees)
+        scalar_t velocity;           // measured velocity (inches / second, or degrees / second during turns)
+        scalar_t rotVelocity;        // measured angular velocity (degrees / second)
+        scalar_t lookAheadDistance;  // look ahead distance (inches) of pure pursuit motions, 0 otherwise
+        bool firstLoop;                 // whether this is the first control loop of the motion
+    };
 
-/**
- * Exit Condition template for linear motions
- * Pass args * 1000 as template arguments
- */
+    // signature of a user supplied exit condition
+    typedef bool (*Predicate)(const Sample&);
+
+    // time (milliseconds) between control loops of the movement functions
+    static constexpr uint32_t loopPeriod = 10;
+    // number of consecutive noisy control loops tolerated before the settle and stuck counters reset
+    static constexpr uint16_t noiseLoops = 5;
+
+    // constructs exit conditions with no checks enabled, the motion only ends if stopped
+    ExitConditions();
+
+    /**
+     * Builder functions, return a copy with the check enabled so exit conditions can be composed
+     * ex: ExitConditions {}.withTolerance(1, 10).withVelocityTolerance(0.5, 2).withSettleTime(150).withTimeout(3000)
+     */
+
+    // exit once error <= maxError and |rotError| <= maxRotError for the settle time
+    // the error is signed, so a linear motion that overshoots its target is within tolerance (turns pass |error|)
+    // also exits during the first control loop if error <= maxError (the motion started at the target)
+    ExitConditions withTolerance(scalar_t maxError, scalar_t maxRotError = INFINITY) const;
+    // additionally require |velocity| <= maxVelocity and |rotVelocity| <= maxRotVelocity to be considered settled
+    ExitConditions withVelocityTolerance(scalar_t maxVelocity, scalar_t maxRotVelocity = INFINITY) const;
+    // time (milliseconds) the motion must remain settled to exit
+    ExitConditions withSettleTime(uint32_t time) const;
+    // exit once |velocity| <= maxVelocity and |rotVelocity| <= maxRotVelocity for time milliseconds
+    ExitConditions withStuckDetection(scalar_t maxVelocity, scalar_t maxRotVelocity, uint32_t time) const;
+    // exit once the motion has run for time milliseconds
+    ExitConditions withTimeout(uint32_t time) const;
+    // exit once the error is within the look ahead distance
+    ExitConditions withLookAheadExit() const;
+    // exit once predicate returns true
+    ExitConditions withCondition(Predicate predicate) const;
+
+    // Resets the tracked state, called at the start of every motion
+    void reset();
+
+    // Updates the tracked state and returns true if the motion should exit, call once per control loop
+    bool operator()(const Sample& sample);
+
+    // Returns the time (milliseconds) since the motion first came within tolerance, or if it never did,
+    // the time it has been stuck; used to profile how long motions spend settling
+    uint32_t getSettleTime() const;
 
-template <
-    
-    long maxLinearError = 1000,
-    long maxLinearDerivative = 500,
-    
-    long maxRotError = 10000,
-    long maxRotDerivative = 2000,
-
-    long minTime = 150,
-
-    long maxTimeStuck = 1500
-
->
-static bool defaultLinearExit(long double curDist, bool firstLoop, bool reset) {
-    // track time stuck
-    static uint16_t count       = 0;
-    static uint16_t stuckCount  = 0;
-    static uint16_t noiseCount  = 0;
-    if (reset) {
-        count = 0;
-        stuckCount = 0;
-        noiseCount = 0;
-        return false;
-    }
-    if (firstLoop) {
-        if (curDist <= maxLinearError / 1000.0) {
-            return true; // exit if starting sufficiently close to target
-        }
-    }
-    if (fabs(linearPID.getDerivative()) <= maxLinearDerivative / 1000.0
-        && fabs(rotPID.getDerivative()) <= maxRotDerivative / 1000.0
-    ) {
-        ++stuckCount; // increment time stuck
-        stuckCount += noiseCount; // increment by time where derivative noise disrupted the exit conditions
-        if (stuckCount >= maxTimeStuck / 10) {
-            return true; // exit if stuck
-        } else if (
-            curDist <= maxLinearError / 1000.0
-            && fabs(rotPID.getError()) <= maxRotError / 1000.0
-        ) {
-            ++count; // increment time near target
-            count += noiseCount; // increment by time where derivative noise disrupted the exit conditions
-            if (count >= minTime / 10) {
-                return true; // exit if settled (derivative evaluated earlier) near target
-            }
-        } else {
-            count = 0;
-        }
-        noiseCount = 0; // derivative noise is not currently significant enough to wrongfully stop exit
-    } else if (stuckCount > 0) {
-        ++noiseCount; // account for derivative noise
-        if (noiseCount >= 5) { // if derivative is likely indeed outside acceptable thresholds, reset the counts
-            count = 0;
-            stuckCount = 0;
-            noiseCount = 0;
-        }
-    }
-    return false;
-}
+private:
+
+    /* Configuration */
+
+    bool hasTolerance;
+    scalar_t maxError;
+    scalar_t maxRotError;
+    scalar_t maxVelocity;
+    scalar_t maxRotVelocity;
+    uint16_t settleLoops;
+
+    bool hasStuckDetection;
+    scalar_t stuckVelocity;
+    scalar_t stuckRotVelocity;
+    uint16_t stuckLoops;
+
+    uint16_t timeoutLoops; // 0 for no timeout
+
+    bool exitAtLookAhead;
+
+    Predicate predicate; // nullptr for no predicate
+
+    /* Tracked state */
+
+    uint16_t elapsedLoops;
+    uint16_t toleranceLoop; // value of elapsedLoops when first within tolerance, 0 if never
+    uint16_t settleCount;
+    uint16_t settleNoiseCount;
+    uint16_t stuckCount;
+    uint16_t stuckNoiseCount;
+
+};
 
 /**
- * Exit Condition template for turns
- * Pass args * 1000 as template arguments
+ * Factory functions matching the default exit conditions
  */
 
-template<
-    
-    long maxError = 10000,
-    long maxDerivative = 2000,
-
-    long minTime = 150,
-
-    long maxTimeStuck = 1500
-
->
-static bool defaultTurnExit(bool firstLoop, bool reset) {
-    // track time stuck
-    static uint16_t count       = 0;
-    static uint16_t stuckCount  = 0;
-    static uint16_t noiseCount  = 0;
-    if (reset) {
-        count = 0;
-        stuckCount = 0;
-        noiseCount = 0;
-        return false;
-    }
-    if (firstLoop) {
-        if (fabs(rotPID.getError()) <= maxError / 1000.0) {
-            return true; // exit if starting sufficiently close to target
-        }
-    }
-    if (fabs(rotPID.getDerivative()) <= maxDerivative / 1000.0) {
-        ++stuckCount; // increment time stuck
-        stuckCount += noiseCount; // increment by time where derivative noise disrupted the exit conditions
-        if (stuckCount >= maxTimeStuck / 10) {
-            return true; // exit if stuck
-        } else if (fabs(rotPID.getError()) <= maxError / 1000.0) {
-            ++count;
-            count += noiseCount; // increment by time where derivative noise disrupted the exit conditions
-            if (count >= minTime / 10) {
-                return true; // exit if settled (derivative evaluated earlier) near target
-            }
-        } else {
-            count = 0;
-        }
-        noiseCount = 0; // derivative noise is not currently significant enough to wrongfully stop exit
-    } else if (stuckCount > 0) {
-        ++noiseCount; // account for derivative noise
-        if (noiseCount >= 5) { // if derivative is likely indeed outside acceptable thresholds, reset the counts
-            count = 0;
-            stuckCount = 0;
-            noiseCount = 0;
-        }
-    }
-    return false;
-}
+// Exit conditions for linear motions, velocities are in inches / second and degrees / second, times are in milliseconds
+static ExitConditions linearExit(
+    scalar_t maxLinearError = 1, scalar_t maxLinearVelocity = 0.5,
+    scalar_t maxRotError = 10, scalar_t maxRotVelocity = 2,
+    uint32_t minTime = 150, uint32_t maxTimeStuck = 1500
+);
 
+// Exit conditions for turns, velocities are in degrees / second, times are in milliseconds
+static ExitConditions turnExit(
+    scalar_t maxError = 10, scalar_t maxVelocity = 2,
+    uint32_t minTime = 150, uint32_t maxTimeStuck = 1500
+);
+
+// Exit conditions for pure pursuit motions, velocities are in inches / second, times are in milliseconds
+static ExitConditions purePursuitExit(scalar_t stuckVelocity = 0.5, uint32_t maxTimeStuck = 1500);
+
+#endif
 #endif
-#endif
\ No newline at end of file
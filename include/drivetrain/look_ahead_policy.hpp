@@ -0,0 +1,37 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _LOOK_AHEAD_POLICY_HPP_
+#define _LOOK_AHEAD_POLICY_HPP_
+
+/**
+ * Separate file for the Drivetrain::LookAheadPolicy declaration
+ * included in drivetrain.hpp
+ *
+ * LookAheadPolicy determines the look ahead distance used by pure pursuit and motion profile error correction
+ *
+ * The distance grows with speed (so fast, straight motions are not over-corrected)
+ * and shrinks with the curvature of the upcoming path (so tight maneuvers follow the path closely):
+ *      distance = (minDistance + velocityGain * |velocity|) / (1 + curvatureGain * |curvature|), bounded by [minDistance, maxDistance]
+ *
+ * A single distance converts to a fixed look ahead distance, so a distance can be passed wherever a policy is expected
+ */
+
+struct Drivetrain::LookAheadPolicy {
+
+    // fixed look ahead distance, in inches
+    LookAheadPolicy(scalar_t distance);
+    // adaptive look ahead distance
+    // distances are in inches, velocityGain is in seconds (inches of look ahead per inch per second), curvatureGain is in inches
+    LookAheadPolicy(scalar_t minDistance, scalar_t maxDistance, scalar_t velocityGain, scalar_t curvatureGain);
+
+    // Returns the look ahead distance given the velocity (inches per second) and the curvature (1 / inches) of the upcoming path
+    scalar_t at(scalar_t velocity, scalar_t curvature) const;
+
+    scalar_t minDistance;
+    scalar_t maxDistance;
+    scalar_t velocityGain;
+    scalar_t curvatureGain;
+
+};
+
+#endif
+#endif
@@ -0,0 +1,61 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _MOTION_HANDLE_HPP_
+#define _MOTION_HANDLE_HPP_
+
+/**
+ * Separate file for the Drivetrain::MotionHandle declaration
+ * included in drivetrain.hpp
+ *
+ * A MotionHandle is returned by the asynchronous movement functions (moveToAsync, turnToAsync, ...)
+ * The motion itself is executed by the drive task, the handle allows the auton task to
+ * wait on, poll, or cancel the motion while it runs subsystem code concurrently
+ *
+ * Handles are cheap to copy, all copies refer to the same motion
+ */
+
+class Drivetrain::MotionHandle final {
+public:
+
+    // states a motion can be in, see Drivetrain::MotionStatus
+    using Status = MotionStatus;
+
+    // constructs an empty handle that refers to no motion (is considered completed)
+    MotionHandle();
+
+    // Blocks the calling task until the motion is no longer queued or running, or until timeout milliseconds pass
+    // Returns true if the motion finished
+    // MUTEX LOCKING
+    bool wait(uint32_t timeout = TIMEOUT_MAX) const;
+
+    // Returns true if the motion is no longer queued or running
+    // MUTEX LOCKING
+    bool isDone() const;
+
+    // Returns the current state of the motion
+    // MUTEX LOCKING
+    Status getStatus() const;
+
+    // Returns the remaining error (inches, or degrees during turns) of the motion as of the last control loop
+    // Returns NAN if the motion has not started
+    // MUTEX LOCKING
+    scalar_t getError() const;
+
+    // Cancels the motion: a queued motion is skipped, a running motion is stopped as if stopMotion was called
+    // MUTEX LOCKING
+    void cancel();
+
+    // Allow Drivetrain to create handles and update their state
+    friend class Drivetrain;
+
+private:
+
+    // constructor used by Drivetrain when queueing a motion
+    explicit MotionHandle(std::shared_ptr<MotionState> state);
+
+    // shared with the motion queue, protected by Drivetrain::motionQueueMutex
+    std::shared_ptr<MotionState> state;
+
+};
+
+#endif
+#endif
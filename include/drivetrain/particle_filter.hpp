@@ -0,0 +1,120 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _PARTICLE_FILTER_HPP_
+#define _PARTICLE_FILTER_HPP_
+
+/**
+ * Separate file for the Drivetrain::ParticleFilter declaration
+ * included in drivetrain.hpp
+ *
+ * ParticleFilter is a Monte Carlo localizer over the field, used to keep the position accurate during long runs (skills)
+ * Each particle is a guess of the pose (x, y, theta), weighted by how well it explains the sensor readings:
+ *      Motion: the change in the odometry pose (poseEstimator) moves every particle, with added noise
+ *      Distance sensors: each particle ray casts the sensor against the field walls
+ *      GPS: each particle is compared to the position reported by the GPS
+ *
+ * Distance sensor readings are modeled as a mix of the expected wall distance and a uniform chance of hitting something else,
+ * so robots and field elements in front of a sensor lower the weights evenly rather than pulling the particles away
+ * Particles are resampled (systematic resampling) once the weights become uneven
+ *
+ * The particle pool has a fixed size and is stored as arrays of floats (one array per variable), no memory is allocated
+ * The per particle loops do not branch, so the work done per update is fixed (well under 2 ms on the brain)
+ *
+ * ParticleFilter does not access any devices, sensor readings are passed to its functions, so it can be run off of the robot
+ */
+
+class Drivetrain::ParticleFilter final {
+public:
+
+    // number of particles in the pool
+    static constexpr size_t particleCount = 200;
+
+    // constructor, particles are at the middle of the field until reset is called
+    ParticleFilter();
+
+    // Spreads the particles around the pose (theta in radians), with standard deviations positionSpread (in)
+    // and headingSpread (radians), sets every weight equal, and sets the odometry reference to the pose
+    void reset(scalar_t x, scalar_t y, scalar_t theta, scalar_t positionSpread, scalar_t headingSpread);
+
+    // Moves every particle by the change in the odometry pose (theta in radians) since the odometry reference,
+    // then sets the odometry reference to the pose
+    void predict(scalar_t odometryX, scalar_t odometryY, scalar_t odometryTheta);
+    // Sets the odometry reference without moving the particles, use when the odometry pose is corrected
+    void setOdometryReference(scalar_t odometryX, scalar_t odometryY, scalar_t odometryTheta);
+
+    // Weights the particles by the distance (in) to the field walls measured by the sensor at mount
+    void correctWallDistance(const DistanceSensorMount& mount, scalar_t reading);
+
+    // Weights the particles by the position (in) reported by the GPS, with standard deviation error (in)
+    void correctGps(scalar_t x, scalar_t y, scalar_t error);
+
+    // Resamples the particles if the weights are uneven (the effective number of particles is under half of the pool)
+    void resample();
+
+    // return the weighted mean pose, theta is in radians on the interval [-pi, pi]
+    scalar_t getX() const;
+    scalar_t getY() const;
+    scalar_t getTheta() const;
+    // returns the standard deviation (inches) of the distance between the particles and the weighted mean position
+    scalar_t getSpread() const;
+
+private:
+
+    // Recomputes the weighted mean pose and spread, called after the particles or weights change
+    void updateEstimate();
+    // Scales the weights to sum to 1, resets them to be equal if every weight is 0
+    void normalizeWeights();
+
+    // returns a pseudo random number, uniform on the interval [0, 1)
+    float uniform();
+    // returns a pseudo random number, approximately normal with mean 0 and standard deviation 1
+    float gaussian();
+
+    // particle poses and weights, the sine and cosine of each heading are cached for the ray casts
+    float x[particleCount];
+    float y[particleCount];
+    float theta[particleCount];
+    float sine[particleCount];
+    float cosine[particleCount];
+    float weight[particleCount];
+
+    // scratch space for resampling
+    float resampledX[particleCount];
+    float resampledY[particleCount];
+    float resampledTheta[particleCount];
+
+    // odometry pose the particles were last moved to
+    scalar_t referenceX;
+    scalar_t referenceY;
+    scalar_t referenceTheta;
+
+    // weighted mean pose and spread
+    scalar_t meanX;
+    scalar_t meanY;
+    scalar_t meanTheta;
+    scalar_t spread;
+
+    // state of the xorshift pseudo random number generator
+    uint32_t randomState;
+
+    /**
+     * Noise constants (standard deviations)
+     *
+     * Instantiated in src/drivetrain/constants.cpp
+     */
+
+    // motion noise, added to every particle when it is moved
+    static const scalar_t motionNoiseRatio;         // in / in traveled
+    static const scalar_t motionNoiseFloor;         // in, per prediction
+    static const scalar_t headingNoiseRatio;        // radians / radian turned
+    static const scalar_t headingNoiseFloor;        // radians, per prediction
+
+    // measurement noise
+    static const scalar_t wallDistanceNoise;        // in
+    static const scalar_t wallDistanceNoiseRatio;   // in / in of the reading
+    // chance that a distance sensor reading is of something other than the wall
+    static const scalar_t outlierProbability;
+
+};
+
+#endif
+#endif
@@ -17,13 +17,16 @@ public:
     // Motion profile data struct, stored in internal array
     // x and y extensions are used (followed at a look ahead distance) for feedback error correction
     // Feedback error correction uses similar ideas to pure pursuit
+    // The look ahead distance is precomputed for every step from the profiled velocity and the curvature of the path
     struct Velocities {
 
         int linearVoltage;
         int rotVoltage;
         
-        long double xExtension;
-        long double yExtension;
+        scalar_t xExtension;
+        scalar_t yExtension;
+
+        scalar_t lookAheadDistance;
     
     };
 
@@ -34,7 +37,8 @@ public:
 
     // constructor to initialize a Path from a pre-generated array
     // This is for profiles generated by external programs
-    Path(Velocities* path, size_t length, Point target, long double lookAheadDist);
+    // Velocities with a lookAheadDistance of 0 (not specified) are followed at lookAheadDist
+    Path(Velocities* path, size_t length, Point target, scalar_t lookAheadDist);
 
     // destructor
     ~Path();
@@ -43,14 +47,15 @@ public:
     void operator=(const Path&) = delete;
 
     // Store an action to be executed during the next movement
-    Path& withAction(std::function<void()>&& action, double dist);
+    Path& withAction(std::function<void()>&& action, scalar_t dist);
 
     // Motion profile generation functions
-    // Those without a lookAheadDist parameter are pointed to by function pointers in the drive namespace for easier calls
+    // Those without a lookAhead parameter are pointed to by function pointers in the drive namespace for easier calls
+    // and use defaultLookAheadPolicy, pass a distance for a fixed look ahead distance
     static Path generatePathTo(Point point);
     static Path generatePath(Point start, Point end);
-    static Path generatePathTo(Point point, long double lookAheadDist);
-    static Path generatePath(Point start, Point end, long double lookAheadDist);
+    static Path generatePathTo(Point point, const LookAheadPolicy& lookAhead);
+    static Path generatePath(Point start, Point end, const LookAheadPolicy& lookAhead);
 
     // Index the internal array
     const Velocities& operator[](size_t index) const;
@@ -62,13 +67,13 @@ public:
     // Get the size (not capacity) of the internal array
     size_t size() const;
 
-    // Allow Drivetrain movement functions to access lookAheadDistance, target
+    // Allow Drivetrain movement functions to access target
     friend class Drivetrain;
 
 private:
 
     // Initialize a Path, called by motion profile generating functions
-    Path(Point target, long double lookAheadDist);
+    explicit Path(Point target);
 
     // Store the final target (for determining when to execute stored actions)
     Point target;
@@ -80,11 +85,8 @@ private:
     size_t length;
     size_t capacity;
 
-    // Stores the lookAheadDistance (for feedback error correction)
-    const long double lookAheadDistance;
-
     // Adds a new Velocities to the internal array, reallocates memory if needed
-    void add(int linearVoltage, int rotVoltage, long double xExtension, long double yExtension);
+    void add(int linearVoltage, int rotVoltage, scalar_t xExtension, scalar_t yExtension, scalar_t lookAheadDistance);
 
 };
 
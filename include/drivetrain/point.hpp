@@ -9,40 +9,40 @@
 
 // simple (x, y) coord data
 struct Drivetrain::XYPoint {
-    long double x;
-    long double y;
+    scalar_t x;
+    scalar_t y;
 };
 
 // Stores (x, y) location and heading
 // Allows storing actions to be executed during the next movement
 struct Drivetrain::Point {
 
-    Point(long double x, long double y, long double heading);
+    Point(scalar_t x, scalar_t y, scalar_t heading);
 
     // Store action
-    Point& withAction(std::function<void()>&& action, double dist, bool duringTurn = false);
+    Point& withAction(std::function<void()>&& action, scalar_t dist, bool duringTurn = false);
 
-    long double x;
-    long double y;
-    long double heading;
+    scalar_t x;
+    scalar_t y;
+    scalar_t heading;
 
 };
 
 // Stores location data for pure pursuit
 struct Drivetrain::Waypoint {
 
-    Waypoint(long double x, long double y);
+    Waypoint(scalar_t x, scalar_t y);
 
     // Store actions to be executed during the next movement (or pure pursuit segment)
-    Waypoint& withAction(std::function<void()>&& action, double dist, bool duringTurn = false);
-    // Change the look ahead distance for the movement to this point
-    Waypoint& withLookAhead(long double newLookAhead);
+    Waypoint& withAction(std::function<void()>&& action, scalar_t dist, bool duringTurn = false);
+    // Change the look ahead distance for the movement to this point, pass a distance for a fixed look ahead distance
+    Waypoint& withLookAhead(const LookAheadPolicy& newLookAhead);
     // Change the exit conditions for the movement to this point
-    Waypoint& withExitCondition(PurePursuitExitConditions newExitConditions);
+    Waypoint& withExitCondition(const PurePursuitExitConditions& newExitConditions);
 
-    long double x;
-    long double y;
-    long double lookAheadDistance {defaultLookAheadDistance};
+    scalar_t x;
+    scalar_t y;
+    LookAheadPolicy lookAheadPolicy {defaultLookAheadPolicy};
     PurePursuitExitConditions exitConditions {defaultPurePursuitExit};
 
 };
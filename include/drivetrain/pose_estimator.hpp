@@ -0,0 +1,158 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _POSE_ESTIMATOR_HPP_
+#define _POSE_ESTIMATOR_HPP_
+
+/**
+ * Separate file for the Drivetrain::PoseEstimator declaration
+ * included in drivetrain.hpp
+ *
+ * PoseEstimator is an extended Kalman filter that fuses every Drivetrain position sensor into one estimate:
+ *      Tracking wheels: distance traveled by the parallel and perpendicular wheels
+ *      Drive motor encoders: distance traveled by the left and right sides
+ *      IMUs: rotation reported by both IMUs, each with its own tracked bias (drift), and the rate of rotation of each gyro
+ *
+ * State: x (in), y (in), theta (radians, counterclockwise, not wrapped), v (in / s, forward),
+ * vLateral (in / s, sideways sliding, to the right is positive), omega (radians / s), and the bias (radians) of each IMU
+ *
+ * Each update corrects the velocities with the encoder readings (which measure the average velocities over the update),
+ * moves the pose along the arc given by the corrected velocities, then corrects the heading with the IMU readings
+ * Every reading is a single scalar correction, so the work done per control loop is fixed
+ * Readings that are not finite (such as from a disconnected IMU) are skipped
+ *
+ * Distance sensor readings can also correct the pose against the field walls (ray cast from the sensor's mounting position),
+ * readings are rejected unless the sensor faces a single wall squarely and the reading agrees with the estimate
+ * (within innovationGate standard deviations), so robots and field elements in front of the sensor are ignored
+ *
+ * PoseEstimator does not access any devices, sensor readings are passed to update, so it can be run off of the robot
+ */
+
+// uncertainty of the estimated position, units are inches and degrees
+struct Drivetrain::PoseCovariance {
+    scalar_t xx;
+    scalar_t xy;
+    scalar_t xHeading;
+    scalar_t yy;
+    scalar_t yHeading;
+    scalar_t headingHeading;
+};
+
+// velocities and accelerations of the Drivetrain, units are inches and degrees, counterclockwise is positive
+struct Drivetrain::Kinematics {
+    scalar_t linearVelocity;        // in / s, forward is positive
+    scalar_t angularVelocity;       // deg / s
+    scalar_t linearAcceleration;    // in / s^2
+    scalar_t angularAcceleration;   // deg / s^2
+};
+
+// position and direction of a distance sensor on the Drivetrain, relative to the tracking center
+struct Drivetrain::DistanceSensorMount {
+    scalar_t forwardOffset;     // in, forward of the tracking center
+    scalar_t leftOffset;        // in, left of the tracking center
+    scalar_t angle;             // radians, counterclockwise from forward, direction the sensor faces
+};
+
+class Drivetrain::PoseEstimator final {
+public:
+
+    // indices of the state variables
+    enum StateIndex : size_t {
+        xIndex, yIndex, thetaIndex, vIndex, vLateralIndex, omegaIndex, imu1BiasIndex, imu2BiasIndex, stateSize
+    };
+
+    // sensor readings taken during one control loop
+    struct Measurements {
+        scalar_t parallelDist;          // in, parallel tracking wheel travel since the last update
+        scalar_t perpendicularDist;     // in, perpendicular tracking wheel travel since the last update
+        scalar_t leftDist;              // in, left drive side travel over driveDt
+        scalar_t rightDist;             // in, right drive side travel over driveDt
+        scalar_t imu1Rotation;          // radians, counterclockwise rotation reported by imu1
+        scalar_t imu2Rotation;          // radians, counterclockwise rotation reported by imu2
+        scalar_t imu1Rate;              // radians / s, counterclockwise rate of rotation reported by imu1's gyro
+        scalar_t imu2Rate;              // radians / s, counterclockwise rate of rotation reported by imu2's gyro
+        scalar_t driveDt;               // s, time the drive side travel was measured over (the motors update every 10 ms,
+                                        // which can be longer than the time since the last update)
+    };
+
+    // constructor, the pose is unknown until reset is called
+    PoseEstimator();
+
+    // Sets the pose (theta in radians) with no uncertainty, IMU biases are set so the last IMU readings match theta
+    void reset(scalar_t x, scalar_t y, scalar_t theta);
+
+    // Predicts the state dt seconds ahead, then corrects it with the sensor readings
+    void update(const Measurements& measurements, scalar_t dt);
+
+    // Corrects the pose with the distance (in) to the field walls measured by the sensor at mount
+    // returns false if the reading was rejected
+    bool correctWallDistance(const DistanceSensorMount& mount, scalar_t reading);
+    // Corrects the position with a measured position (in) with variance (in^2) in each direction
+    void correctPosition(scalar_t x, scalar_t y, scalar_t variance);
+
+    // return the estimated pose, theta is in radians and is not wrapped
+    scalar_t getX() const;
+    scalar_t getY() const;
+    scalar_t getTheta() const;
+    // return the estimated velocities, v is in inches / second (forward is positive), omega is in radians / second
+    scalar_t getV() const;
+    scalar_t getOmega() const;
+
+    // returns the covariance of the estimated position
+    PoseCovariance getCovariance() const;
+
+private:
+
+    // Moves the pose dt seconds along the arc given by the velocities, and propagates the covariance
+    void predict(scalar_t dt);
+
+    // Corrects the state with a scalar reading modeled as the dot product of h and the state, with variance noiseVariance
+    void correct(const scalar_t (&h)[stateSize], scalar_t reading, scalar_t noiseVariance);
+    // Corrects the state with the difference between a reading and its predicted value, h is the gradient of the prediction
+    // returns false (without correcting) if the innovation is further than maxDeviations standard deviations from 0
+    bool correctInnovation(
+        const scalar_t (&h)[stateSize], scalar_t innovation, scalar_t noiseVariance, scalar_t maxDeviations = INFINITY
+    );
+
+    scalar_t state[stateSize];
+    scalar_t covariance[stateSize][stateSize];
+
+    // last IMU readings, used to set the IMU biases when reset
+    scalar_t lastImu1Rotation;
+    scalar_t lastImu2Rotation;
+
+    /**
+     * Noise constants (standard deviations)
+     *
+     * Instantiated in src/drivetrain/constants.cpp
+     */
+
+    // process noise
+    static const scalar_t accelerationNoise;
+    static const scalar_t lateralAccelerationNoise;
+    static const scalar_t angularAccelerationNoise;
+    static const scalar_t imuBiasDrift;
+    static const scalar_t positionDrift;
+
+    // measurement noise, per update
+    static const scalar_t trackingWheelNoise;
+    static const scalar_t driveEncoderNoise;
+    static const scalar_t imuNoise;
+    static const scalar_t gyroRateNoise;
+    static const scalar_t wallDistanceNoise;
+    static const scalar_t wallDistanceNoiseRatio;
+
+    /**
+     * Wall reading rejection, instantiated in src/drivetrain/constants.cpp
+     * The field walls are the lines x = 0, y = 0, x = Drivetrain::fieldLength, and y = Drivetrain::fieldLength
+     */
+
+    // radians, readings are rejected if the sensor faces further than this from square to the wall
+    static const scalar_t maxWallIncidence;
+    // in, readings are rejected if the sensor faces within this of a corner (it could see either wall)
+    static const scalar_t wallCornerMargin;
+    // standard deviations, readings that disagree with the estimate by more than this are rejected
+    static const scalar_t innovationGate;
+
+};
+
+#endif
+#endif
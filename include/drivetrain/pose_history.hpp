@@ -0,0 +1,64 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _POSE_HISTORY_HPP_
+#define _POSE_HISTORY_HPP_
+
+#include <atomic>
+#include <cstdio>
+
+/**
+ * Separate file for the Drivetrain::PoseHistory declaration
+ * included in drivetrain.hpp
+ *
+ * PoseHistory is a ring buffer of timestamped poses recorded by odometry (the last capacity updates, 5 s at 100 Hz)
+ * Use it to find where the Drivetrain was when a sensor reading was captured, or to dump the recent trajectory
+ *
+ * Lookups are O(1): the slot is estimated from the time since the newest pose and the average time between poses
+ * (odometry runs at a fixed rate), then the pose is interpolated between the two poses around the time
+ *
+ * There is one writer (odometry) and any number of readers, no mutex is used:
+ * each slot stores the index it was written with, which readers check before and after copying the slot,
+ * so a slot being overwritten while it is read is detected and the read is retried
+ */
+
+class Drivetrain::PoseHistory final {
+public:
+
+    // number of poses stored, a power of 2 so indices wrap with a mask
+    static constexpr uint32_t capacity = 512;
+
+    // constructor, the history is empty
+    PoseHistory();
+
+    // Records the pose at time (microseconds, from pros::micros), times must increase between calls
+    // Only one task may record
+    void record(uint64_t time, scalar_t x, scalar_t y, scalar_t heading);
+
+    // Returns the pose (heading in degrees on the interval [0, 360)) at time (microseconds), interpolated between
+    // the recorded poses around time, returns false if time is not within the stored history
+    bool poseAt(uint64_t time, scalar_t& x, scalar_t& y, scalar_t& heading) const;
+
+    // Writes the stored history, oldest first, as csv (time in microseconds, x, y, heading) to file
+    void write(FILE* file) const;
+
+private:
+
+    // a recorded pose, index is the number of poses recorded before it (UINT32_MAX while it is being written)
+    struct Entry {
+        std::atomic<uint32_t> index;
+        uint64_t time;
+        scalar_t x;
+        scalar_t y;
+        scalar_t heading;
+    };
+
+    // Copies the pose recorded with the index, returns false if it is no longer stored
+    bool read(uint32_t index, uint64_t& time, scalar_t& x, scalar_t& y, scalar_t& heading) const;
+
+    Entry entries[capacity];
+    // number of poses recorded
+    std::atomic<uint32_t> count;
+
+};
+
+#endif
+#endif
@@ -0,0 +1,64 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _POWER_MANAGER_HPP_
+#define _POWER_MANAGER_HPP_
+
+#include <atomic>
+
+/**
+ * Separate file for the Drivetrain::PowerManager declaration
+ * included in drivetrain.hpp
+ *
+ * PowerManager limits the voltage of each drive motor before the motor limits itself:
+ *      motors are derated linearly between two temperatures, the V5 motors throttle themselves at 55 degrees C
+ *      motors that draw more than a sustainable current (low pass filtered) are scaled down toward it
+ *
+ * The three motors on each side share a gearbox, so they are all given the same voltage (a motor given less would
+ * brake against the others), and a side's capacity is the limit of its weakest motor
+ * Both sides are capped to the weaker side's capacity, preserving the ratio of the side voltages, so the drivetrain
+ * derates predictably (it slows down rather than curving) and commands under the cap are unchanged
+ *
+ * The limits are only updated in the sensor task (SensorHub::sample) and are shared with the drive and opcontrol tasks
+ * through the available power, which is atomic
+ *
+ * The available power (fraction of full voltage both sides can supply) also scales the max velocity and acceleration
+ * used to generate motion profiles
+ */
+
+class Drivetrain::PowerManager final {
+public:
+
+    // number of drive motors, ordered front left, top back left, bottom back left, front right, top back right, bottom back right
+    static constexpr size_t motorCount = 6;
+
+    // constructor, every motor starts unlimited
+    PowerManager();
+
+    // Updates the motor limits from the temperatures and current draws in snapshot, does nothing if it was already used
+    // only called in the sensor task, after each snapshot is published
+    void update(const SensorHub::Snapshot& snapshot);
+
+    // Sets the motor voltages (mV) from the side voltages, within the motor limits
+    // the side's motors are given the same voltage
+    void distribute(int32_t leftVoltage, int32_t rightVoltage, int32_t voltages[motorCount]) const;
+
+    // returns the fraction of full voltage both sides of the drivetrain can currently supply, 1 if no motor is limited
+    scalar_t getAvailablePower() const;
+
+private:
+
+    // fraction of full voltage each motor may be supplied, only used in the sensor task
+    scalar_t motorLimit[motorCount];
+    // low pass filtered current draw (mA) of each motor
+    scalar_t filteredCurrent[motorCount];
+
+    // snapshot the limits were last updated with
+    uint32_t lastSequence;
+    uint64_t lastTime;
+
+    // read by motion profile generation in other tasks
+    std::atomic<float> availablePower;
+
+};
+
+#endif
+#endif
@@ -0,0 +1,79 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _PURE_PURSUIT_PATH_HPP_
+#define _PURE_PURSUIT_PATH_HPP_
+
+#include <initializer_list>
+
+/**
+ * Separate file for the Drivetrain::PurePursuitPath declaration
+ * included in drivetrain.hpp
+ *
+ * PurePursuitPath stores a polyline (starting from where the Drivetrain was last told to go) and tracks progress along it
+ *
+ * Each control loop, the closest point on the path is found within a window of segments starting at the current segment
+ * Progress along the path never decreases, so the look ahead point cannot jump backwards,
+ * and the look ahead point is searched for past the end of the current segment
+ * The search window is fixed, so each control loop takes constant time regardless of path length
+ */
+
+class Drivetrain::PurePursuitPath final {
+public:
+
+    // Max number of points (not including the starting point) a PurePursuitPath can store
+    static constexpr size_t maxPoints = 32;
+    // Number of segments, starting from the current segment, searched each control loop
+    static constexpr size_t searchWindow = 3;
+
+    // constructor, points are followed in order; points beyond maxPoints are ignored
+    // ex: base << PurePursuitPath {{3_ft, 2.5_ft}, {6_ft, 4_ft}, {9_ft, 3_ft}};
+    PurePursuitPath(std::initializer_list<XYPoint> points);
+
+    // Store an action to be executed during the next movement, dist is the distance remaining along the path
+    PurePursuitPath& withAction(std::function<void()>&& action, scalar_t dist);
+    // Change the look ahead distance for the movement, pass a distance for a fixed look ahead distance
+    PurePursuitPath& withLookAhead(const LookAheadPolicy& newLookAhead);
+    // Change the exit conditions for the movement
+    PurePursuitPath& withExitCondition(const PurePursuitExitConditions& newExitConditions);
+
+    // Returns the final point of the path
+    XYPoint getEndpoint() const;
+
+    // Allow Drivetrain movement functions to track progress along the path
+    friend class Drivetrain;
+
+private:
+
+    // Sets the starting point of the path and resets tracked progress, called at the start of a motion
+    void begin(XYPoint start);
+
+    // Updates the tracked closest point (progress never decreases) and returns the point to target
+    XYPoint lookAhead(XYPoint position, scalar_t lookAheadDist);
+
+    // Returns the distance left to travel along the path from the tracked closest point
+    scalar_t remainingDistance() const;
+
+    // Returns the curvature (1 / inches) of the path over the span inches following the tracked closest point
+    scalar_t upcomingCurvature(scalar_t span) const;
+
+    // Returns the point distAlong inches along the path, searching forward from the current segment within the search window
+    XYPoint pointAt(scalar_t distAlong) const;
+
+    // points of the path, points[0] is the starting point set by begin
+    XYPoint points[maxPoints + 1];
+    // distance along the path from points[0] to each point
+    scalar_t distanceTo[maxPoints + 1];
+    // number of points stored, including the starting point
+    size_t length;
+
+    // index of the segment (points[segment] to points[segment + 1]) containing the tracked closest point
+    size_t segment;
+    // distance along the path of the tracked closest point
+    scalar_t progress;
+
+    LookAheadPolicy lookAheadPolicy {defaultLookAheadPolicy};
+    PurePursuitExitConditions exitConditions {defaultPurePursuitExit};
+
+};
+
+#endif
+#endif
@@ -0,0 +1,88 @@
+#ifdef _DRIVETRAIN_HPP_
+#ifndef _TRACKING_WHEELS_HPP_
+#define _TRACKING_WHEELS_HPP_
+
+/**
+ * Separate file for the Drivetrain::TrackingWheels declarations
+ * included in drivetrain.hpp
+ *
+ * TrackingWheels is the interface odometry uses to read the parallel and perpendicular tracking wheels,
+ * so the sensors they are mounted on can be swapped without changing odometry:
+ *      ADITrackingWheels: ADI (3 wire) optical shaft encoders, 360 ticks per rotation, updated every 10 ms
+ *      RotationTrackingWheels: V5 Rotation sensors, 36000 centidegrees per rotation, updated every 5 ms
+ *
+ * The tracking wheels used are selected in src/devices.cpp with ROTATION_SENSOR_ODOMETRY (include/macros.h)
+ * Odometry runs at the update period of the tracking wheels
+ */
+
+class Drivetrain::TrackingWheels {
+public:
+
+    virtual ~TrackingWheels() = default;
+
+    // Configures the sensors and zeros the tracking wheel positions, called before odometry starts
+    virtual void reset() = 0;
+
+    // Returns the distance (in) traveled by each tracking wheel since reset, NAN if the sensor could not be read
+    virtual scalar_t getParallelDistance() = 0;
+    virtual scalar_t getPerpendicularDistance() = 0;
+
+    // Returns the time (milliseconds) between sensor updates
+    virtual uint32_t getUpdatePeriod() const = 0;
+
+};
+
+class Drivetrain::ADITrackingWheels final : public TrackingWheels {
+public:
+
+    // constructor, ports are the top and bottom ADI ports of each encoder
+    ADITrackingWheels(
+        char parallelTopPort, char parallelBottomPort, char perpendicularTopPort, char perpendicularBottomPort, bool reversed
+    );
+
+    void reset() override;
+
+    scalar_t getParallelDistance() override;
+    scalar_t getPerpendicularDistance() override;
+
+    uint32_t getUpdatePeriod() const override;
+
+private:
+
+    // Converts encoder ticks to inches traveled
+    static scalar_t ticksToInches(int32_t ticks);
+
+    pros::ADIEncoder parallelEncoder;
+    pros::ADIEncoder perpendicularEncoder;
+
+};
+
+class Drivetrain::RotationTrackingWheels final : public TrackingWheels {
+public:
+
+    // time (milliseconds) between Rotation sensor updates, the fastest data rate the sensors support
+    static constexpr uint32_t dataRate = 5;
+
+    // constructor, the direction of the sensors is set when reset
+    RotationTrackingWheels(uint8_t parallelPort, uint8_t perpendicularPort, bool reversed);
+
+    void reset() override;
+
+    scalar_t getParallelDistance() override;
+    scalar_t getPerpendicularDistance() override;
+
+    uint32_t getUpdatePeriod() const override;
+
+private:
+
+    // Converts a Rotation sensor position (centidegrees) to inches traveled, NAN if the read failed
+    static scalar_t centidegreesToInches(int32_t centidegrees);
+
+    pros::Rotation parallelSensor;
+    pros::Rotation perpendicularSensor;
+    bool reversed;
+
+};
+
+#endif
+#endif
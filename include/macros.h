@@ -15,4 +15,22 @@
 // When defined, driver control will default to make use of autonomous functions for subsystem 3
 // #define DEFAULT_TO_MACROS_IN_OPCONTROL
 
+// When defined, the control math (odometry, PID, motion profiling, pure pursuit) uses float rather than double
+// #define SINGLE_PRECISION_MATH
+
+// When defined, the tracking wheels are read from V5 Rotation sensors rather than ADI encoders,
+// and odometry runs in its own task at 200 Hz (the Rotation sensor data rate) rather than in mainTasks at 100 Hz
+// #define ROTATION_SENSOR_ODOMETRY
+
+// When defined, autonomous() profiles where the time of each auton run goes, and writes the breakdown to the terminal
+// when the run ends (include/auton_profiler.hpp); leave undefined in competition, it locks a mutex in every motion
+// #define AUTON_PROFILING
+
+// When defined, every auton run is a robustness trial: seeded start position error, sensor noise, and battery sag are applied,
+// and the result is logged (include/robustness_trial.hpp)
+// #define ROBUSTNESS_TRIALS
+
+// When defined with ROBUSTNESS_TRIALS, every trial uses this seed, to repeat the disturbances of a failed trial
+// #define ROBUSTNESS_TRIAL_SEED 0
+
 #endif
\ No newline at end of file
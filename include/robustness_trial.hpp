@@ -0,0 +1,136 @@
+#ifndef _ROBUSTNESS_TRIAL_HPP_
+#define _ROBUSTNESS_TRIAL_HPP_
+
+#include "api.h"
+#include "sensor_hub.hpp"
+#include "util/scalar.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Declaration for the static RobustnessTrial class
+ *
+ * With ROBUSTNESS_TRIALS defined (include/macros.h), every auton run is a trial: disturbances drawn from a seed are
+ * applied while the auton runs, to measure how often the auton (and its timing sensitive exit conditions) fails under
+ *      start position error: the first setPosition of the run is offset, as if the bot was placed off its start position
+ *      sensor noise: IMU rotations drift (random walk) and distance sensor readings are noisy, in each Snapshot
+ *      battery sag: the drive motors only receive a fraction of the commanded voltage
+ *
+ * A trial ends when the auton calls end at the point its result is decided (ex: right after a goal rush, before holding
+ * position until the end of the period), otherwise when the auton returns or the period ends (see endAutonRun)
+ * A trial fails if it ends after the auton's time limit, if the period ended first, or if the auton calls fail
+ * (ex: a goal rush that stopped short)
+ * Each trial is written as a csv line (seed, result, time, disturbances) to the terminal and /usd/robustness_trials.csv,
+ * and the success rate and completion times of the trials since power on are written after each trial
+ *
+ * The disturbances and the noise sequence are determined by the seed alone (the random numbers are generated here
+ * rather than by the standard library, whose distributions differ between implementations)
+ * Define ROBUSTNESS_TRIAL_SEED as the seed of a failed trial to repeat its disturbances; the run itself also depends on
+ * where the bot is placed, the field, and task timing, so a repeated trial is not guaranteed to fail the same way
+ */
+
+class RobustnessTrial final {
+public:
+
+    // disturbances applied during a trial
+    struct Disturbances {
+        scalar_t startX;            // in, added to the start position
+        scalar_t startY;            // in
+        scalar_t startHeading;      // degrees
+        scalar_t imuDrift;          // degrees, standard deviation of the IMU rotation drift per snapshot
+        scalar_t distanceNoise;     // in, standard deviation of the noise added to each distance sensor reading
+        scalar_t voltageScale;      // fraction of the commanded drive voltage delivered
+    };
+
+    // Starts a trial with the next seed (ROBUSTNESS_TRIAL_SEED if defined), call before the auton runs
+    // the auton has budget milliseconds to end the trial
+    static void begin(uint32_t budget);
+    // Marks the current trial as failed, reason is kept until the trial ends (it must outlive the trial)
+    // Does nothing if no trial is running
+    static void fail(const char* reason);
+    // Ends the current trial, recording its result, fails the trial if it ran longer than its budget
+    // Does nothing if no trial is running, so an auton can end its trial before autonomous ends it
+    static void end();
+
+    // Returns true while a trial is running
+    static bool isActive();
+
+    /**
+     * Disturbance functions, called by the code that is disturbed while a trial is running
+     */
+
+    // Offsets a start position by the start position error, only the first call of a trial is offset
+    static void disturbStart(scalar_t& x, scalar_t& y, scalar_t& heading);
+    // Adds sensor noise to snapshot, called in the sensor task for each snapshot
+    static void disturbSnapshot(SensorHub::Snapshot& snapshot);
+    // Returns the voltage (mV) a drive motor receives when voltage is commanded
+    static int32_t disturbVoltage(int32_t voltage);
+
+    // Writes the number of trials, success rate, completion time distribution, and failed seeds since power on to file
+    static void writeSummary(FILE* file = stdout);
+
+private:
+
+    // deterministic random number generator (splitmix64)
+    class Random final {
+    public:
+
+        void seed(uint64_t seed);
+        // uniformly distributed on [0, 1)
+        scalar_t uniform();
+        // uniformly distributed on [-range, range]
+        scalar_t uniform(scalar_t range);
+        // normally distributed with mean 0
+        scalar_t gaussian(scalar_t standardDeviation);
+
+    private:
+
+        uint64_t state {0};
+
+    };
+
+    /* Disturbance ranges */
+
+    // start position error is uniform within these (in, degrees)
+    static const scalar_t startPositionError;
+    static const scalar_t startHeadingError;
+    // noise standard deviations are uniform from 0 up to these (degrees, in)
+    static const scalar_t maxImuDrift;
+    static const scalar_t maxDistanceNoise;
+    // the delivered fraction of the drive voltage is uniform from this up to 1
+    static const scalar_t minVoltageScale;
+
+    /* Current trial */
+
+    static std::atomic<bool> active;
+    static uint32_t seed;
+    // pros::millis when the trial started, and the time (milliseconds) the auton has to end it
+    static uint32_t startTime;
+    static uint32_t budget;
+    static Disturbances disturbances;
+    static bool startDisturbed;
+    static const char* failureReason;
+    // only used in the sensor task once the trial is active
+    static Random sensorRandom;
+    static scalar_t imu1Drift;
+    static scalar_t imu2Drift;
+
+    /* Results since power on */
+
+    static constexpr size_t resultCapacity = 256;
+    static constexpr size_t failedSeedCapacity = 16;
+
+    static uint32_t nextSeed;
+    static uint32_t trials;
+    static uint32_t successes;
+    // completion times (milliseconds) of the first resultCapacity successful trials
+    static uint32_t completionTimes[resultCapacity];
+    static uint32_t failedSeeds[failedSeedCapacity];
+
+    static pros::Mutex mutex;
+
+};
+
+#endif
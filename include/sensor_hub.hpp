@@ -0,0 +1,98 @@
+#ifndef _SENSOR_HUB_HPP_
+#define _SENSOR_HUB_HPP_
+
+#include "api.h"
+#include "util/scalar.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Declaration for the static SensorHub class
+ *
+ * SensorHub samples every device that updates every 10 ms (drive motors, IMUs, distance sensors, GPS, lift motor)
+ * once per tick, in the sensor task, into a timestamped Snapshot
+ * Odometry, the lift state machine, and autons read the latest Snapshot instead of reading the devices themselves,
+ * so each device is read once per tick and every reader sees readings from the same moment
+ *
+ * The tracking wheels are not sampled, odometry reads them itself since it runs at their update rate,
+ * which can be faster than 10 ms (ROTATION_SENSOR_ODOMETRY)
+ *
+ * Snapshots are double buffered and no mutex is used: the sensor task fills the buffer readers are not using,
+ * then publishes it; each buffer stores the sequence number it was written with, which readers check before and after
+ * copying it, so a buffer being overwritten while it is read is detected and the read is retried
+ */
+
+class SensorHub final {
+public:
+
+    // readings of every sampled device at one moment
+    // readings that failed are NAN or infinity (PROS_ERR_F)
+    struct Snapshot {
+
+        // time (microseconds, from pros::micros) sampling started
+        uint64_t time {0};
+        // number of snapshots taken before this one, 0 until the first snapshot is taken
+        uint32_t sequence {0};
+
+        // degrees, average of the motors on each side of the drivetrain
+        scalar_t leftDrivePosition  {NAN};
+        scalar_t rightDrivePosition {NAN};
+        // temperature (degrees C) and current draw (mA) of each drive motor, ordered front left, top back left,
+        // bottom back left, front right, top back right, bottom back right
+        scalar_t driveTemperatures[6]   {NAN, NAN, NAN, NAN, NAN, NAN};
+        scalar_t driveCurrents[6]       {NAN, NAN, NAN, NAN, NAN, NAN};
+
+        // IMU rotation (degrees) and yaw rate (degrees/s), clockwise is positive
+        scalar_t imu1Rotation   {NAN};
+        scalar_t imu2Rotation   {NAN};
+        scalar_t imu1Rate       {NAN};
+        scalar_t imu2Rate       {NAN};
+
+        // distance sensor readings (in), NAN if nothing usable was detected
+        scalar_t leftDistance   {NAN};
+        scalar_t backDistance   {NAN};
+
+        // GPS position and error (in), position is measured from the bottom left corner of the field
+        scalar_t gpsX       {NAN};
+        scalar_t gpsY       {NAN};
+        scalar_t gpsError   {NAN};
+
+        // lift motor position (degrees), velocity (degrees/s), current draw (mA), voltage (mV), and temperature (degrees C)
+        scalar_t liftPosition       {NAN};
+        scalar_t liftVelocity       {NAN};
+        scalar_t liftCurrent        {NAN};
+        scalar_t liftVoltage        {NAN};
+        scalar_t liftTemperature    {NAN};
+
+    };
+
+    // time (milliseconds) between snapshots
+    static constexpr uint32_t samplePeriod = 10;
+
+    // returns the latest snapshot
+    static Snapshot getSnapshot();
+
+    // reads every sampled device and publishes the readings as the latest snapshot
+    // called in sensor task, only one task may sample
+    static void sample();
+
+private:
+
+    // a snapshot, and the sequence number it was written with (UINT32_MAX while it is being written)
+    struct Buffer {
+        std::atomic<uint32_t> sequence;
+        Snapshot snapshot;
+    };
+
+    // Returns the reading (in) of sensor, NAN if the reading is unusable
+    static scalar_t readDistanceSensor(pros::Distance& sensor);
+
+    static Buffer buffers[2];
+    // sequence number of the latest snapshot, the snapshot is in buffers[published & 1]
+    static std::atomic<uint32_t> published;
+
+};
+
+#endif
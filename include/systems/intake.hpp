@@ -2,6 +2,7 @@
 #define _INTAKE_HPP_
 
 #include "api.h"
+#include "util/cached_motor.hpp"
 
 /**
  * This file contains the static Intake class
@@ -27,8 +28,8 @@ namespace motor_control {
         
         // the motor itself
         // this is public in case if we want to spin the intake at a different speed for whatever reason
-        // declared in src/devices.cpp
-        static pros::Motor motor;
+        // declared in src/devices.cpp, repeated commands are not sent (see util/cached_motor.hpp)
+        static CachedMotor motor;
 
         // the speed Intake class methods will spin the motor at (on the interval [-127, 127])
         // declared in src/systems/constants.cpp
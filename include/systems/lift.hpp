@@ -2,6 +2,12 @@
 #define _LIFT_HPP_
 
 #include "api.h"
+#include "sensor_hub.hpp"
+#include "util/cached_motor.hpp"
+#include "util/pid_controller.hpp"
+#include "util/trapezoidal_profile.hpp"
+
+#include <cstdio>
 
 /**
  * This file contains the declaration of the static Lift class
@@ -10,6 +16,26 @@
  *
  * This class has autonomous movement in mind, and can move the lift to several preset heights
  * A manual control mode is also available, which is useful for driver control of the lift
+ * Moves between presets follow a trapezoidal motion profile (util/trapezoidal_profile.hpp), so the lift accelerates and
+ * slows down smoothly instead of running at a fixed speed into the hard stops
+ * The profile is tracked by a PIDController on the motor encoder plus feedforward for friction, velocity, acceleration,
+ * and gravity; the gravity term scales with the cosine of the arm angle and increases when the claw is holding a goal
+ *
+ * The state machine is event driven: the methods that change the requested state wake the systems task,
+ * which updates the lift at the control rate while it moves, and at a low supervision rate once it has settled at a preset
+ * (the motor's position controller then holds the preset, unless the voltage is limited) or while it is idle
+ * (manual control with the motor unpowered)
+ * Voltages are only sent to the motor when they change
+ *
+ * Every update also supervises the lift motor (even with manual control enabled):
+ *      the lift is stalled if it draws high current without moving (other than while holding a preset it has reached);
+ *      the voltage is then limited until it moves again
+ *      or a new preset is requested, and if it stalled pushing down near 0 it is on the hard stop and the encoder is zeroed
+ *      the voltage is derated as the motor heats up, before the motor throttles itself
+ * The state machine applies the voltage limit itself; with manual control enabled, apply getVoltageLimit to the commands
+ * sent to the motor (opcontrol does for the raise and lower buttons, its position hold is not limited)
+ * Stalls, re-zeroing, and derating are logged, print the log with writeEventLog after a match
+ *
  * When manual control is enabled, access the public pros::Motor motor to control the lift
  * Do not access the pros::Motor motor when manual control is disabled, as a state machine in a
  * separate task will override commands,
@@ -53,6 +79,11 @@ namespace motor_control {
         // MUTEX LOCKING
         static bool isUp();
 
+        // returns true if the lift has finished moving to the preset requested by the current states
+        // false while manual control is enabled
+        // MUTEX LOCKING
+        static bool isSettled();
+
         // sets the current subposition of the lift to the one specified
         // MUTEX LOCKING
         static void setSubposition(Subposition subpos);
@@ -78,20 +109,36 @@ namespace motor_control {
         // zeros the lift integrated motor encoder
         // MUTEX LOCKING
         static void reset();
+        // returns the max voltage (mV) the lift may be supplied, from the stall and temperature state
+        // apply it to manual commands, ex: lift.motor.move_voltage(lift.getVoltageLimit()) to raise the lift
+        // MUTEX LOCKING
+        static int32_t getVoltageLimit();
+        // returns the number of times the encoder has been zeroed (by init, reset, or a stall on the bottom hard stop)
+        // positions read before the count changed are measured from the old zero
+        // MUTEX LOCKING
+        static uint32_t getZeroCount();
 
         // This function runs the state machine that moves the lift to the appropriate position given the requested states
         // if manual control is disabled
-        // This function uses the motor's built in PID controller to reach the desired position
-        // Called in systems task
+        // When the requested preset changes, a motion profile is planned from the current setpoint to the new preset,
+        // then the profile is tracked with PID and feedforward
+        // returns the time (milliseconds) until powerLift needs to run again if no state changes are made
+        // Called in systems task, which also wakes when the requested state changes
         // MUTEX LOCKING
-        static void powerLift();
+        static uint32_t powerLift();
+
+        // Writes the supervision event log, oldest first, as csv (time in milliseconds, event, position, current,
+        // temperature) to file
+        // MUTEX LOCKING
+        static void writeEventLog(FILE* file = stdout);
 
         // The motor for the physical lift
         // Defined in src/devices.cpp
         // Only access if manual control is enabled, otherwise the mutex guard
         // used by the state machine in systems task (through powerLift) is being bypassed
         // NEEDS MUTEX COVER, used in field control and systems tasks
-        static pros::Motor motor;
+        // Repeated commands are not sent (see util/cached_motor.hpp)
+        static CachedMotor motor;
         
     private:
 
@@ -104,7 +151,124 @@ namespace motor_control {
 
         // preset angles to target depending on lift states
         // heights are lowered, high enough for rings to pass under, lowered onto platform, above platform, and all the way up
-        static const long double angles[5];
+        static const scalar_t angles[5];
+
+        // motion profile between presets, units are motor degrees and seconds
+        // defined in src/systems/constants.cpp
+        static TrapezoidalProfile profile;
+        // tracks the profile setpoint with the motor encoder (degrees)
+        // defined in src/systems/constants.cpp
+        static PIDController pid;
+
+        // feedforward constants (volts), velocities and accelerations are in motor degrees/s and degrees/s^2
+        // kS overcomes friction, kV and kA hold the profile velocity and acceleration,
+        // kG holds the empty lift when the arm is horizontal, kLoad is added to kG when the claw is closed (holding a goal)
+        static const scalar_t kS;
+        static const scalar_t kV;
+        static const scalar_t kA;
+        static const scalar_t kG;
+        static const scalar_t kLoad;
+
+        // motor angle (degrees) at which the arm is horizontal, gravity torque is greatest there
+        static const scalar_t horizontalAngle;
+        // degrees the arm rotates per degree the motor rotates (the inverse of the external gear ratio)
+        static const scalar_t armRatio;
+
+        // index in angles the current profile moves to, noTarget if a new profile must be planned from the measured position
+        // NEEDS MUTEX COVER, used by field control and systems tasks
+        static size_t targetIndex;
+        static constexpr size_t noTarget = SIZE_MAX;
+        // time (microseconds) the current profile started
+        static uint64_t profileStartTime;
+        // time (microseconds) the encoder was last zeroed, lift positions in SensorHub snapshots taken before it are stale
+        static uint64_t zeroTime;
+        // number of times the encoder has been zeroed
+        static uint32_t zeroCount;
+
+        // millivolts last sent to the motor, noVoltage if the next voltage must be sent
+        // NEEDS MUTEX COVER, used by field control and systems tasks
+        static int32_t lastVoltage;
+        static constexpr int32_t noVoltage = INT32_MIN;
+
+        // time (milliseconds) between updates while the lift is moving, and while it is holding a preset or idle
+        static const uint32_t controlPeriod;
+        static const uint32_t supervisionPeriod;
+        // max velocity (rpm) of the motor's position controller while it holds a preset
+        static const int32_t holdVelocity;
+        // distance (motor degrees) from the preset within which the lift is settled once its profile has finished
+        static const scalar_t settledError;
+        // change in voltage (millivolts) needed before a new voltage is sent to the motor
+        static const int32_t voltageDeadband;
+
+        // wakes the systems task so a state change is acted on immediately
+        static void notifyStateChange();
+        // returns the index in angles requested by liftIsUp and subposition
+        // NEEDS MUTEX COVER
+        static size_t requestedIndex();
+
+        // whether the lift has finished its profile within settledError of its target, and is holding the target
+        // NEEDS MUTEX COVER
+        static bool settled;
+
+        /* supervision */
+
+        // events recorded in the supervision log
+        enum class Event {
+            stall,              // high current without moving, voltage limited
+            stallCleared,       // moving again or a new preset was requested
+            zeroed,             // stalled on the bottom hard stop, encoder zeroed
+            derating,           // voltage limited due to motor temperature
+            derateCleared       // motor has cooled, full voltage available
+        };
+
+        // a logged event, with the readings when it happened
+        struct LogEntry {
+            uint32_t time; // milliseconds
+            Event event;
+            scalar_t position;
+            scalar_t current;
+            scalar_t temperature;
+        };
+
+        // Detects stalls (zeroing the encoder on the bottom hard stop) and sets the voltage limit from the motor temperature
+        // called in powerLift
+        // NEEDS MUTEX COVER
+        static void supervise(const SensorHub::Snapshot& snapshot);
+        // Adds an event to the log, overwriting the oldest if the log is full
+        // NEEDS MUTEX COVER
+        static void logEvent(Event event, const SensorHub::Snapshot& snapshot);
+
+        // stall detection thresholds: speed (degrees/s), current (mA), and time (milliseconds) spent stalling
+        static const scalar_t stallVelocity;
+        static const scalar_t stallCurrent;
+        static const uint32_t stallTime;
+        // the encoder is only zeroed by a downward stall if the lift measures within zeroWindow (degrees) of 0
+        static const scalar_t zeroWindow;
+        // max voltage (mV) while stalled
+        static const int32_t stallVoltageLimit;
+        // temperatures (degrees C) derating starts at, and reaches minVoltageFraction at
+        static const scalar_t derateStartTemperature;
+        static const scalar_t derateEndTemperature;
+        static const scalar_t minVoltageFraction;
+
+        // time (microseconds) the lift started stalling, 0 if it is not stalling
+        // NEEDS MUTEX COVER
+        static uint64_t stallStartTime;
+        // whether the current stall has been detected (and the voltage limited)
+        // NEEDS MUTEX COVER
+        static bool stalled;
+        // max voltage (mV) powerLift may supply, from the stall and temperature state
+        // NEEDS MUTEX COVER
+        static int32_t voltageLimit;
+        // whether the voltage is currently derated due to temperature
+        // NEEDS MUTEX COVER
+        static bool derating;
+
+        // ring buffer of the last logCapacity events
+        // NEEDS MUTEX COVER
+        static constexpr size_t logCapacity = 32;
+        static LogEntry eventLog[logCapacity];
+        static size_t loggedEvents;
 
         // state variable to store whether the lift is currently up
         // NEEDS MUTEX COVER, used by field control and systems tasks
@@ -0,0 +1,96 @@
+#ifndef _CACHED_MOTOR_HPP_
+#define _CACHED_MOTOR_HPP_
+
+#include "api.h"
+#include "util/scalar.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * This file contains the declaration of CachedMotor, a pros::Motor that skips redundant commands
+ *
+ * Control loops command their motors every cycle, usually with the same command they sent last cycle
+ * (a stopped intake is stopped again, a drivetrain at rest is supplied 0 again, the lift holds the same angle)
+ * Every command is a write on the smart port bus, so CachedMotor remembers the last command sent to the motor
+ * and does not send a command equal to it
+ * The last command is still resent every refreshPeriod, so a motor that was unplugged and reconnected is commanded again
+ *
+ * move_relative is always sent, and zeroing the encoder clears the cached command, since both change the meaning of
+ * the next absolute position command
+ *
+ * Sent and skipped commands are counted for every CachedMotor, to measure smart port traffic
+ *
+ * A CachedMotor should only be commanded by one task at a time, the cached command is not protected by a mutex
+ */
+
+namespace motor_control {
+
+    class CachedMotor final : public pros::Motor {
+    public:
+
+        // time (milliseconds) after which a command equal to the last one is sent anyway
+        static constexpr uint32_t refreshPeriod = 250;
+
+        // constructor, same parameters as pros::Motor
+        CachedMotor(std::uint8_t port, pros::motor_gearset_e_t gearset, bool reverse);
+
+        // pros::Motor commands, skipped (returning 1, success) if equal to the last command sent
+        std::int32_t move(std::int32_t voltage) const override;
+        std::int32_t move_absolute(const double position, const std::int32_t velocity) const override;
+        std::int32_t move_velocity(const std::int32_t velocity) const override;
+        std::int32_t move_voltage(const std::int32_t voltage) const override;
+
+        // always sent, clears the cached command
+        std::int32_t move_relative(const double position, const std::int32_t velocity) const override;
+        std::int32_t tare_position() const override;
+        std::int32_t set_zero_position(const double position) const override;
+
+        // clears the cached command so the next command is sent
+        void invalidate() const;
+
+        // returns the number of commands sent to and skipped for this motor
+        uint32_t getWrites() const;
+        uint32_t getSkippedWrites() const;
+
+        // restarts the traffic measurement of every CachedMotor
+        static void resetWriteCounts();
+        // return the commands sent and skipped per second, over every CachedMotor, since resetWriteCounts was called
+        static scalar_t getWriteRate();
+        static scalar_t getSkippedWriteRate();
+
+    private:
+
+        // kinds of commands that are cached
+        enum class Command {
+            none,
+            move,
+            moveAbsolute,
+            moveVelocity,
+            moveVoltage
+        };
+
+        // returns true if the command can be skipped, otherwise records it as the last command sent
+        // updates the write counts
+        bool skip(Command command, double value, std::int32_t velocity = 0) const;
+
+        // last command sent, and the time (milliseconds) it was sent
+        mutable Command lastCommand     {Command::none};
+        mutable double lastValue        {0};
+        mutable std::int32_t lastVelocity {0};
+        mutable uint32_t lastWriteTime  {0};
+
+        // commands sent to and skipped for this motor
+        mutable uint32_t writes         {0};
+        mutable uint32_t skippedWrites  {0};
+
+        // commands sent and skipped over every CachedMotor since countStartTime (milliseconds)
+        static std::atomic<uint32_t> totalWrites;
+        static std::atomic<uint32_t> totalSkippedWrites;
+        static std::atomic<uint32_t> countStartTime;
+
+    };
+
+} // namespace motor_control
+
+#endif
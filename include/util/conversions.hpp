@@ -1,6 +1,8 @@
 #ifndef _CONVERSIONS_HPP_
 #define _CONVERSIONS_HPP_
 
+#include "util/scalar.hpp"
+
 /**
  * File for conversion literals and functions, pi variable
  *
@@ -11,39 +13,39 @@
 
 namespace conversions {
 
-    constexpr long double pi = 3.1415926535L;
+    constexpr scalar_t pi = 3.1415926535;
 
-    constexpr long double operator"" _in(long double length) {
+    constexpr scalar_t operator"" _in(long double length) {
         return length;
     }
-    constexpr long double operator"" _in(unsigned long long length) {
+    constexpr scalar_t operator"" _in(unsigned long long length) {
         return length;
     }
-    constexpr long double operator"" _ft(long double length) {
+    constexpr scalar_t operator"" _ft(long double length) {
         return length * 12;
     }
-    constexpr long double operator"" _ft(unsigned long long length) {
+    constexpr scalar_t operator"" _ft(unsigned long long length) {
         return length * 12;
     }
 
-    constexpr long double operator"" _deg(long double angle) {
+    constexpr scalar_t operator"" _deg(long double angle) {
         return angle;
     }
-    constexpr long double operator"" _deg(unsigned long long angle) {
+    constexpr scalar_t operator"" _deg(unsigned long long angle) {
         return angle;
     }
-    constexpr long double operator"" _rad(long double angle) {
+    constexpr scalar_t operator"" _rad(long double angle) {
         return angle * 180 / pi;
     }
-    constexpr long double operator"" _rad(unsigned long long angle) {
+    constexpr scalar_t operator"" _rad(unsigned long long angle) {
         return angle * 180 / pi;
     }
 
-    constexpr long double radians(long double degrees) {
+    constexpr scalar_t radians(scalar_t degrees) {
         return degrees * pi / 180;
     }
 
-    constexpr long double degrees(long double radians) {
+    constexpr scalar_t degrees(scalar_t radians) {
         return radians * 180 / pi;
     }
 
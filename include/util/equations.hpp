@@ -1,6 +1,8 @@
 #ifndef _EQUATIONS_HPP_
 #define _EQUATIONS_HPP_
 
+#include "util/scalar.hpp"
+
 /**
  * This file contains declarations for classes utilized by the path and trajectory generation used in motion profiling
  */
@@ -8,7 +10,7 @@
 namespace equations {
 
     // returns the distance between two points given the difference in their x and y positions
-    double distance(double dx, double dy);
+    scalar_t distance(scalar_t dx, scalar_t dy);
 
     /**
      * PolynomialEquation is a class for an up to five term polynomial
@@ -22,11 +24,11 @@ namespace equations {
     public:
 
         // constructor, with coefficients of terms followed by the power that respective term is raised to
-        PolynomialEquation(long double a, int pow1, long double b, int pow2, long double c,
-            int pow3, long double d, int pow4, long double e, int pow5);
+        PolynomialEquation(scalar_t a, int pow1, scalar_t b, int pow2, scalar_t c,
+            int pow3, scalar_t d, int pow4, scalar_t e, int pow5);
 
         // returns the value of the function at the given point
-        long double at(long double value) const;
+        scalar_t at(scalar_t value) const;
 
         // returns the derivative PolynomialEquation
         PolynomialEquation derivative() const;
@@ -34,11 +36,11 @@ namespace equations {
     private:
 
         // coefficients of the terms
-        const long double a;
-        const long double b;
-        const long double c;
-        const long double d;
-        const long double e;
+        const scalar_t a;
+        const scalar_t b;
+        const scalar_t c;
+        const scalar_t d;
+        const scalar_t e;
 
         // powers the terms are raised to
         const int pow1;
@@ -63,7 +65,7 @@ namespace equations {
             const PolynomialEquation& yd, const PolynomialEquation& ydd);
 
         // returns the curvature (which is equivalent to 1 / r) at a current value along a parametric curve
-        long double at(long double value) const;
+        scalar_t at(scalar_t value) const;
 
     private:
 
@@ -88,14 +90,14 @@ namespace equations {
 
         // constructor, takes the first derivatives of the x and y components of a parametric equation as well as a time step
         // a higher time step will yield a more accurate answer at the expense of computation time
-        DistanceToTime(const PolynomialEquation& xd, const PolynomialEquation& yd, long double step);
+        DistanceToTime(const PolynomialEquation& xd, const PolynomialEquation& yd, scalar_t step);
 
         // Converts a distance along a parametric path to the value of the parametric parameter
         // at which that distance has been traveled (starting from t = 0)
         // For optimization, it is assumed that the values of dist subsequently
         // passed to atDistance of an instance of DistanceToTime are always increasing
         // A value from 0 to 1 is returned
-        long double atDistance(long double dist);
+        scalar_t atDistance(scalar_t dist);
 
     private:
 
@@ -105,12 +107,12 @@ namespace equations {
         const PolynomialEquation& xd;
         const PolynomialEquation& yd;
         // the amount the guessed parametric parameter is incremented by (smaller step is more accurate)
-        const long double step;
+        const scalar_t step;
 
         // the current guess at the value of the parametric parameter
-        long double time;
+        scalar_t time;
         // the current distance along the path that has been transversed (from t = 0 to t = time)
-        long double accumulatedDistance;
+        scalar_t accumulatedDistance;
 
     };
 
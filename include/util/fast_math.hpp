@@ -0,0 +1,32 @@
+#ifndef _FAST_MATH_HPP_
+#define _FAST_MATH_HPP_
+
+#include "util/scalar.hpp"
+
+/**
+ * File for fast approximations of trig functions used in the 100 Hz control loops (odometry, pure pursuit, movements)
+ *
+ * Angles are in radians
+ * Approximations are polynomials evaluated after range reduction, with a max error of under 0.001 degrees
+ * (sin and cos are within 0.00002 of the exact value, atan2 is within 0.00002 radians of the exact angle)
+ *
+ * Path generation, which is not time critical, uses the standard library functions
+ */
+
+namespace fast_math {
+
+    // returns the sine of angle
+    scalar_t sin(scalar_t angle);
+
+    // returns the cosine of angle
+    scalar_t cos(scalar_t angle);
+
+    // sets sine and cosine to the sine and cosine of angle, cheaper than calling sin and cos separately
+    void sincos(scalar_t angle, scalar_t& sine, scalar_t& cosine);
+
+    // returns the angle, on the interval [-pi, pi], of the point (x, y) from the positive x axis
+    scalar_t atan2(scalar_t y, scalar_t x);
+
+} // namespace fast_math
+
+#endif
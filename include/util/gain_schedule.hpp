@@ -0,0 +1,66 @@
+#ifndef _GAIN_SCHEDULE_HPP_
+#define _GAIN_SCHEDULE_HPP_
+
+#include "util/scalar.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+
+/**
+ * This file contains the declaration of a gain schedule for PIDController
+ *
+ * A single set of gains cannot settle both short and long motions quickly:
+ * gains that settle a 6 inch move overshoot a 10 foot move, and gains tuned for long moves are sluggish on short ones
+ *
+ * GainSchedule stores a small table of gains, sorted by a key, and linearly interpolates between entries
+ * Keys outside of the table use the gains of the nearest entry
+ * The table has a fixed max size, so looking up gains does not allocate memory
+ */
+
+namespace motor_control {
+
+    class GainSchedule final {
+    public:
+
+        // Max number of entries a GainSchedule can store
+        static constexpr size_t maxEntries = 8;
+
+        // value the gains are scheduled by
+        enum class Key {
+            motionSize,     // size of the motion, supplied with PIDController::setNewTarget
+            speed           // commanded speed, supplied with PIDController::setScheduleSpeed
+        };
+
+        // gains used when the key equals key
+        // note the derivative gain (kD) comes before the integral gain (kI)
+        struct Entry {
+            scalar_t key;
+            scalar_t kP;
+            scalar_t kD;
+            scalar_t kI;
+        };
+
+        // constructs an empty schedule, PIDController uses its constant gains
+        GainSchedule();
+        // constructor, entries must be sorted by key (ascending); entries beyond maxEntries are ignored
+        GainSchedule(Key key, std::initializer_list<Entry> entries);
+
+        // returns true if there are no entries (the schedule is unused)
+        bool empty() const;
+        // returns the value the gains are scheduled by
+        Key getKey() const;
+
+        // returns the gains interpolated at value, do not call on an empty schedule
+        Entry at(scalar_t value) const;
+
+    private:
+
+        Key key;
+        Entry entries[maxEntries];
+        size_t length;
+
+    };
+
+} // namespace motor_control
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef _PID_HPP_
 #define _PID_HPP_
 
+#include "util/gain_schedule.hpp"
+#include "util/scalar.hpp"
+
+#include <cmath>
 #include <cstdint>
 
 /**
@@ -11,13 +15,21 @@
  * PIDController does this by providing a suggestion of what voltage the motors should run at
  *
  * Drivetrain uses two PID controllers, one for distance from the target and one for heading
- * Lift uses the motor's integrated PID control; this is accurate for our purposes,
- * so there is no need to use this PIDController for Lift
+ * Lift uses a PIDController to track its motion profile (see include/systems/lift.hpp)
  *
  * PIDController also implements slew control, which is a one dimensional trapezoidal motion profile for the start of motions
  * Without slew control, at the start of most motions (new requested target state)
  * PIDController will immediately suggest that the motors run at max voltage
  *
+ * Time between calcPower calls is measured in microseconds, so loop jitter does not distort the derivative and integral terms
+ * The derivative is passed through a first order low pass filter, and can optionally be taken on the measurement
+ * (rather than the error) so target changes do not kick the derivative term
+ *
+ * The PID gains can be scheduled (see util/gain_schedule.hpp) by the size of the motion or the commanded speed
+ * Scheduled gains are looked up once at the start of each motion, not every control loop
+ * The size of the motion is supplied by the caller; targets set without one (ex: heading correction during a drive)
+ * use the constant gains
+ *
  * Unless otherwise noted, units used for voltage are volts
  */
 
@@ -29,14 +41,17 @@ namespace motor_control {
         // struct to contain current PID and slew constants
         struct Constants {
 
-            const long double kP;
-            const long double kD;
-            const long double kI;
-            const long double integralCap;
+            const scalar_t kP;
+            const scalar_t kD;
+            const scalar_t kI;
+            const scalar_t integralCap;
 
-            const long double voltageAcceleration;
-            const long double maxVoltage;
-            const long double startingVoltage;
+            const scalar_t voltageAcceleration;
+            const scalar_t maxVoltage;
+            const scalar_t startingVoltage;
+
+            const scalar_t derivativeFilterTime;
+            const bool derivativeOnMeasurement;
 
         };
 
@@ -45,19 +60,27 @@ namespace motor_control {
         // integral cap limits the max voltage that the integral term can supply
         // the last three parameters dictate slew control, and have units of volts/s^s, volts, and volts respectively
         // if voltageAcceleration <= 0, slew control will not be used
-        PIDController(long double kP, long double kD = 0, long double kI = 0, long double integralCap = 4,
-            long double voltageAcceleration = 0, long double maxVoltage = 12, long double startingVoltage = 0);
+        // derivativeFilterTime is the time constant (seconds) of the derivative low pass filter, 0 disables the filter
+        // if gainSchedule is not empty, it overrides kP, kD, and kI for motions it applies to
+        PIDController(scalar_t kP, scalar_t kD = 0, scalar_t kI = 0, scalar_t integralCap = 4,
+            scalar_t voltageAcceleration = 0, scalar_t maxVoltage = 12, scalar_t startingVoltage = 0,
+            scalar_t derivativeFilterTime = 0, const GainSchedule& gainSchedule = GainSchedule {});
 
         // returns the error of the system when calcPower was last run
-        long double getError();
-        // returns the derivative of the system when calc power was last run
-        long double getDerivative();
+        scalar_t getError();
+        // returns the (filtered) derivative of the error when calc power was last run
+        scalar_t getDerivative();
 
         // resets the PIDController and sets a new target
         // if ignoreProfile is true, slew is disabled until the next reset, otherwise slew is enabled (if voltageAcceleration > 0)
-        void setNewTarget(long double newTarget, bool ignoreProfile = false);
+        // motionSize is the size of the motion for gain schedules keyed by GainSchedule::Key::motionSize,
+        // NAN uses the constant gains for the motion
+        void setNewTarget(scalar_t newTarget, bool ignoreProfile = false, scalar_t motionSize = NAN);
         // changes the target, does not reset slew, derivative, or integral terms
-        void alterTarget(long double newTarget);
+        void alterTarget(scalar_t newTarget);
+        // changes the target without resetting slew or integral terms, used to blend one motion into the next
+        // the derivative is reseeded during the next calcPower call, so the jump in error does not cause a derivative kick
+        void blendTarget(scalar_t newTarget);
 
         // Inform the PIDController of updates to the system's output since calcPower was last ran
         // (example: after a motion that does not utilize PID)
@@ -65,52 +88,81 @@ namespace motor_control {
         void updatePreviousSystemOutput(int previousSystemOutput);
 
         // returns a suggestion for the millivolts to supply to the system, based off of the current position of said system
+        // feedforward (volts) is added to the PID output before it is bounded and slewed
         // units are millivolts because pros::Motor::move_voltage uses millivolts
-        int calcPower(long double currPos);
+        int calcPower(scalar_t currPos, scalar_t feedforward = 0);
 
-        // returns the current gains for both PID and slew
+        // returns the current gains for both PID and slew (the scheduled gains if the motion is scheduled)
         Constants getConstants();
-        // sets the PID gains
+        // sets the constant PID gains, used for motions the gain schedule does not apply to
         // note the derivative gain (newKD) comes before the integral gain (newKI)
-        void setConstants(long double newKP, long double newKD, long double newKI, long double newIntegralCap);
+        void setConstants(scalar_t newKP, scalar_t newKD, scalar_t newKI, scalar_t newIntegralCap);
+        // sets the gain schedule, pass an empty GainSchedule to use constant gains
+        void setGainSchedule(const GainSchedule& newGainSchedule);
+        // sets the commanded speed used by gain schedules keyed by GainSchedule::Key::speed, applied at the start of the next motion
+        void setScheduleSpeed(scalar_t speed);
         // sets the slew constants with units of volts/s^s, volts, and volts respectively
         // if voltageAcceleration <= 0, slew control will not be used
-        void setSlewConstants(long double newVoltageAcceleration, long double newMaxVoltage, long double newStartingVoltage);
+        void setSlewConstants(scalar_t newVoltageAcceleration, scalar_t newMaxVoltage, scalar_t newStartingVoltage);
+        // sets the time constant (seconds) of the derivative low pass filter, and whether the derivative is taken on the measurement
+        // taking the derivative on the measurement requires currPos to be continuous when the target changes
+        void setDerivativeFilter(scalar_t newDerivativeFilterTime, bool newDerivativeOnMeasurement = false);
 
     private:
 
-        // PID gains
-        long double kP;
-        long double kD;
-        long double kI;
-        long double integralCap;
+        // sets kP, kD, and kI to the scheduled gains at value, or to the constant gains if value is NAN
+        void applyGainSchedule(scalar_t value);
+
+        // PID gains used for the current motion
+        scalar_t kP;
+        scalar_t kD;
+        scalar_t kI;
+        scalar_t integralCap;
+        // PID gains used for motions that are not scheduled
+        scalar_t constantKP;
+        scalar_t constantKD;
+        scalar_t constantKI;
 
         // positional data for the system
-        long double target      {0};
-        long double error       {0};
-        long double prevError   {0};
-        long double derivative  {0};
-        long double totalError  {0};
+        scalar_t target      {0};
+        scalar_t error       {0};
+        scalar_t prevError   {0};
+        scalar_t derivative  {0};
+        scalar_t totalError  {0};
+        scalar_t prevPos     {0};
+
+        // gain schedule, and the motion size or commanded speed it is evaluated at
+        GainSchedule gainSchedule;
+        scalar_t scheduleMotionSize {NAN};
+        scalar_t scheduleSpeed {0};
+
+        // derivative filter constants
+        scalar_t derivativeFilterTime;
+        bool derivativeOnMeasurement {false};
 
         // slew constants
-        long double voltageAcceleration;
-        long double maxVoltage;
-        long double startingVoltage;
+        scalar_t voltageAcceleration;
+        scalar_t maxVoltage;
+        scalar_t startingVoltage;
         // stores the current power to supply due to slew control
-        long double slewPower   {0};
-        // stores the time at which calcPower was last run (for derivative, integral, and slew calculations)
-        uint32_t startTime      {0};
+        scalar_t slewPower   {0};
+        // stores the time (microseconds) at which calcPower was last run (for derivative, integral, and slew calculations)
+        uint64_t startTime      {0};
 
         // state of whether slew control should be used / calculated
         bool usingSlew  {false};
+        // direction of slew acceleration, set at the start of each motion
+        bool positiveSlewAcceleration {true};
         // state of whether calcPower is being called for the first time after a reset
         // When true, the slew profile is given direction,
         // and the previous output will not override the output (which would normally happen if dT between calcPower calls is 0ms)
         bool firstRun   {true};
+        // state of whether the next calcPower call should reseed the derivative (set by blendTarget)
+        bool reseedDerivative {false};
 
         // stores the value of the previous output from the system (either from calcPower or from information supplied by updatePreviousSystemOutput)
         // used when dT between calcPower calls is 0ms and to properly reset the slew profile during a setNewTarget call
-        long double previousOutput {0};
+        scalar_t previousOutput {0};
 
     };
 
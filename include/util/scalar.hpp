@@ -0,0 +1,20 @@
+#ifndef _SCALAR_HPP_
+#define _SCALAR_HPP_
+
+#include "macros.h"
+
+/**
+ * File for the scalar type used by the control math (odometry, PID, motion profiling, pure pursuit, conversions)
+ *
+ * The V5 has no hardware support for long double, which the compiler treats as double,
+ * so the math defaults to double; define SINGLE_PRECISION_MATH in macros.h to use float
+ * float halves the size of stored data (such as Path::Velocities) and uses the single precision path of the FPU
+ */
+
+#ifdef SINGLE_PRECISION_MATH
+typedef float scalar_t;
+#else
+typedef double scalar_t;
+#endif
+
+#endif
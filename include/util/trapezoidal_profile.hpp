@@ -0,0 +1,71 @@
+#ifndef _TRAPEZOIDAL_PROFILE_HPP_
+#define _TRAPEZOIDAL_PROFILE_HPP_
+
+#include "util/scalar.hpp"
+
+/**
+ * This file contains the declaration of a one dimensional trapezoidal motion profile
+ *
+ * A trapezoidal profile accelerates at a constant rate up to a max velocity, cruises, then decelerates at the same rate
+ * so the system comes to rest at the target; short moves never reach the max velocity and have no cruise phase
+ *
+ * The profile can start while the system is already moving (for example when the target changes mid motion),
+ * so the planned velocity is continuous when a new profile replaces an old one
+ * If the system is moving toward the target too fast to stop in time, the starting velocity is reduced to the fastest
+ * velocity that can stop at the target, and feedback control absorbs the difference
+ *
+ * Units are arbitrary but must be consistent (for example motor degrees, degrees/s, degrees/s^2), times are seconds
+ */
+
+namespace motor_control {
+
+    class TrapezoidalProfile final {
+    public:
+
+        // planned position, velocity, and acceleration at a point in the profile
+        struct State {
+            scalar_t position;
+            scalar_t velocity;
+            scalar_t acceleration;
+        };
+
+        // constructor, maxVelocity and maxAcceleration must be positive
+        // the profile is at rest at position 0 until plan is called
+        TrapezoidalProfile(scalar_t maxVelocity, scalar_t maxAcceleration);
+
+        // plans a profile from start, moving with startVelocity, to rest at target
+        void plan(scalar_t start, scalar_t target, scalar_t startVelocity = 0);
+
+        // returns the planned state time seconds after the start of the profile
+        // times after the end of the profile return the target at rest
+        State at(scalar_t time) const;
+
+        // returns the time (seconds) the profile takes to reach the target
+        scalar_t getDuration() const;
+        // returns the target of the profile
+        scalar_t getTarget() const;
+
+    private:
+
+        const scalar_t maxVelocity;
+        const scalar_t maxAcceleration;
+
+        // start and target positions, and +1 or -1 for the direction from start to target
+        scalar_t start      {0};
+        scalar_t target     {0};
+        scalar_t direction  {1};
+
+        // velocities (in the direction of the target) at the start of the profile and during the cruise phase
+        scalar_t startVelocity  {0};
+        scalar_t peakVelocity   {0};
+
+        // end times of the acceleration, cruise, and deceleration phases
+        scalar_t accelerationEnd    {0};
+        scalar_t cruiseEnd          {0};
+        scalar_t decelerationEnd    {0};
+
+    };
+
+} // namespace motor_control
+
+#endif
@@ -0,0 +1,165 @@
+#include "auton_profiler.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+
+/**
+ * This file contains the AutonProfiler definitions
+ */
+
+AutonProfiler::Step AutonProfiler::steps[stepCapacity] {};
+size_t AutonProfiler::stepCount {0};
+
+bool AutonProfiler::running {false};
+uint32_t AutonProfiler::runStartTime {0};
+uint32_t AutonProfiler::lastEndTime {0};
+uint32_t AutonProfiler::runEndTime {0};
+uint32_t AutonProfiler::budget {0};
+
+uint32_t AutonProfiler::totalWait {0};
+uint32_t AutonProfiler::totalMotion {0};
+uint32_t AutonProfiler::totalSettle {0};
+
+pros::Mutex AutonProfiler::mutex {};
+
+// Starts profiling a run that should take at most budget milliseconds, clears the previous run
+void AutonProfiler::start(uint32_t newBudget) {
+mutex.take();
+    stepCount = 0;
+    runStartTime = lastEndTime = runEndTime = pros::millis();
+    budget = newBudget;
+    totalWait = totalMotion = totalSettle = 0;
+    running = true;
+mutex.give();
+}
+
+// Stops profiling, the time since the last motion is counted as wait
+void AutonProfiler::stop() {
+mutex.take(20); // timeout and prevent deadlock if the auton task was killed while recording a motion
+    if (running) {
+        running = false;
+        runEndTime = pros::millis();
+        totalWait += runEndTime - lastEndTime;
+    }
+mutex.give();
+}
+
+// Records a motion that started at startTime and ends now, settleTime milliseconds of which were spent settling
+void AutonProfiler::recordMotion(uint32_t startTime, uint32_t settleTime, const char* label, ...) {
+
+mutex.take();
+
+    if (!running) {
+    mutex.give();
+        return;
+    }
+
+    uint32_t endTime = pros::millis();
+    uint32_t duration = endTime - startTime;
+    uint32_t waitTime = (startTime > lastEndTime ? startTime - lastEndTime : 0);
+    if (settleTime > duration) {
+        settleTime = duration;
+    }
+
+    if (stepCount < stepCapacity) {
+        Step& step = steps[stepCount];
+        va_list args;
+        va_start(args, label);
+        vsnprintf(step.label, sizeof(step.label), label, args);
+        va_end(args);
+        step.startTime = startTime - runStartTime;
+        step.waitTime = waitTime;
+        step.motionTime = duration - settleTime;
+        step.settleTime = settleTime;
+    }
+    ++stepCount;
+
+    totalWait += waitTime;
+    totalMotion += duration - settleTime;
+    totalSettle += settleTime;
+    lastEndTime = endTime;
+
+mutex.give();
+
+}
+
+// Returns the length of the last run, or of the current run so far
+uint32_t AutonProfiler::getRunTime() {
+mutex.take(20);
+    uint32_t runTime = (running ? pros::millis() : runEndTime) - runStartTime;
+mutex.give();
+    return runTime;
+}
+
+// Returns the time limit of the last run
+uint32_t AutonProfiler::getBudget() {
+mutex.take(20);
+    uint32_t runBudget = budget;
+mutex.give();
+    return runBudget;
+}
+
+// Writes the breakdown of the last run to file
+void AutonProfiler::writeReport(FILE* file) {
+
+mutex.take(20);
+
+    uint32_t endTime = (running ? pros::millis() : runEndTime);
+    uint32_t runTime = endTime - runStartTime;
+    uint32_t wait = totalWait + (running ? endTime - lastEndTime : 0);
+
+    fprintf(file, "auton: %lu of %lu ms (%s %lu ms)\n",
+        static_cast<unsigned long>(runTime), static_cast<unsigned long>(budget),
+        (runTime <= budget ? "spare" : "over by"),
+        static_cast<unsigned long>(runTime <= budget ? budget - runTime : runTime - budget)
+    );
+    fprintf(file, "motion %lu ms, settle %lu ms, wait %lu ms, %u motions\n",
+        static_cast<unsigned long>(totalMotion), static_cast<unsigned long>(totalSettle),
+        static_cast<unsigned long>(wait), static_cast<unsigned>(stepCount)
+    );
+
+    size_t storedSteps = std::min(stepCount, stepCapacity);
+    fprintf(file, "step,motion,start,wait,moving,settle\n");
+    for (size_t i = 0; i < storedSteps; ++i) {
+        const Step& step = steps[i];
+        fprintf(file, "%u,%s,%lu,%lu,%lu,%lu\n",
+            static_cast<unsigned>(i), step.label, static_cast<unsigned long>(step.startTime),
+            static_cast<unsigned long>(step.waitTime), static_cast<unsigned long>(step.motionTime),
+            static_cast<unsigned long>(step.settleTime)
+        );
+    }
+    if (stepCount > stepCapacity) {
+        fprintf(file, "(%u more motions not listed)\n", static_cast<unsigned>(stepCount - stepCapacity));
+    }
+
+    writeLargest(file, "settle", &Step::settleTime);
+    writeLargest(file, "wait before", &Step::waitTime);
+
+mutex.give();
+
+}
+
+// Writes the steps with the largest value of member to file
+void AutonProfiler::writeLargest(FILE* file, const char* name, uint32_t Step::*member) {
+
+    size_t storedSteps = std::min(stepCount, stepCapacity);
+    bool listed[stepCapacity] {};
+
+    fprintf(file, "largest %s:\n", name);
+    for (size_t n = 0; n < reportedSteps; ++n) {
+        size_t largest = storedSteps;
+        for (size_t i = 0; i < storedSteps; ++i) {
+            if (!listed[i] && (largest == storedSteps || steps[i].*member > steps[largest].*member)) {
+                largest = i;
+            }
+        }
+        if (largest == storedSteps || steps[largest].*member == 0) {
+            break; // every step with any time has been listed
+        }
+        listed[largest] = true;
+        fprintf(file, "    step %u, %s: %lu ms\n",
+            static_cast<unsigned>(largest), steps[largest].label, static_cast<unsigned long>(steps[largest].*member)
+        );
+    }
+
+}
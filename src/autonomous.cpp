@@ -1,5 +1,7 @@
 #include "autonomous.hpp"
 
+#include <atomic>
+
 // default auton to one that does nothing
 void none() {}
 auton_t auton = none;
@@ -21,6 +23,9 @@ auton_t auton = none;
 const Auton DisplayControl::upperAutons[] {{upperGoalRush, "rush", true}, {upperRing, "ring", true}, {awp, "awp", true}};
 const Auton DisplayControl::lowerAutons[] {{lowerGoalRush, "rush", true}, {skills, "skills"}};
 
+// whether the run started by autonomous has ended, set by the field control task (autonomous) and disabled
+static std::atomic<bool> runEnded {true};
+
 /* Initialize auton specifiers */
 
 bool targetTallNeutralMogo  {false};
@@ -36,19 +41,50 @@ void autonomous() {
 
     lift.setManualControl(false); // allow state machine to power the lift
 
+    runEnded = false;
+#if defined(ROBUSTNESS_TRIALS) || defined(AUTON_PROFILING)
+    uint32_t budget = (auton == skills ? 60000 : 15000); // skills runs are 60 seconds, other autons 15
+#endif
+#ifdef ROBUSTNESS_TRIALS
+    RobustnessTrial::begin(budget);
+#endif
+#ifdef AUTON_PROFILING
+    AutonProfiler::start(budget);
+#endif
+
     auton(); // run the selected autonomous function
+    endAutonRun(true);
 
 }
 
-// specialized exit conditions for the goal rush
-bool goalRushExitConditions(long double dist, bool firstLoop, bool reset) {
+// Ends the run started by autonomous, called when the auton returns and when the period ends (from disabled),
+// as autons that hold their position until the end of the period never return
+// does nothing if the run already ended
+void endAutonRun([[maybe_unused]] bool autonReturned) { // only read with ROBUSTNESS_TRIALS
+
+    if (runEnded.exchange(true)) {
+        return; // the run already ended, or no run was started
+    }
+
+#ifdef AUTON_PROFILING
+    AutonProfiler::stop();
+    AutonProfiler::writeReport(); // where the time went, written to the terminal
+#endif
 
-    static int count = 0;
-    Point pos = base.getPosition();
-    ++count;
-    if (count > 250) { // stop if 2.5 seconds have elapsed
-        return true;
+#ifdef ROBUSTNESS_TRIALS
+    if (!autonReturned) { // does nothing if the auton already ended its trial
+        RobustnessTrial::fail("stopped at the end of the period");
     }
-    return pos.y >= 57 || dist < 0.5; // stop if close enough to target or far enough forward
+    RobustnessTrial::end();
+    RobustnessTrial::writeSummary();
+#endif
 
-}
\ No newline at end of file
+}
+
+// specialized exit conditions for the goal rush
+// stop if close enough to target or far enough forward, or if 2.5 seconds have elapsed
+const ExitConditions goalRushExitConditions = ExitConditions {}
+    .withCondition([](const ExitConditions::Sample& sample){
+        return base.getPosition().y >= 57 || sample.error < 0.5;
+    })
+    .withTimeout(2500);
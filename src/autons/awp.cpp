@@ -4,17 +4,19 @@ void awp() {
 
     base.setPosition(24_in, 1_ft, 0_deg);
 
-    lift.setManualControl(true);
-
-    lift.motor.move(75);
-    do {
-        pros::delay(10);
-    } while (lift.motor.get_position() < 200);
-    lift.release();
-    pros::delay(200);
-
-    lift.setManualControl(false);
-    pros::delay(250);
+    // raise the lift, then release the claw
+    CommandScheduler::runUntilFinished(sequence({
+        functional(
+            []{ lift.setManualControl(true); lift.motor.move(75); },
+            {},
+            []{ return SensorHub::getSnapshot().liftPosition >= 200; },
+            [](bool){ lift.release(); },
+            {Subsystem::lift}
+        ),
+        waitFor(200),
+        instant([]{ lift.setManualControl(false); }, {Subsystem::lift}),
+        waitFor(250)
+    }));
 
     if (!targetShortNeutralMogo && !targetTallNeutralMogo) {
 
@@ -47,7 +49,7 @@ void awp() {
 
         base << Waypoint {3_ft, 2.5_ft} << endAt(9_ft, 3_ft);
         base.limitLinearSpeed(30);
-        base.moveTo(11.4_ft, 3_ft); // , Drivetrain::defaultLinearExit<1000, 50000, 10000, 200000, 150, 200>);
+        base.moveTo(11.4_ft, 3_ft); // , Drivetrain::linearExit(1, 50, 10, 200, 150, 200));
 
         holder.grab();
 
@@ -80,7 +82,13 @@ void awp() {
         base.addAction(lift.clamp, 1_ft);
         base.moveTo(endTarget.x, endTarget.y);
 
-        base.moveTo(9_ft, 3_ft, Drivetrain::defaultLinearExit<0, 0, 0, 0, 15000, 15000>);
+        // the neutral goal is the last score, end the robustness trial before holding until the period ends
+        if (!lift.isClamping()) { // the clamp action runs 1 ft from the goal, the bot stopped short
+            RobustnessTrial::fail("neutral goal rush stopped short");
+        }
+        RobustnessTrial::end();
+
+        base.moveTo(9_ft, 3_ft, Drivetrain::linearExit(0, 0, 0, 0, 15000, 15000));
 
     }
 
@@ -13,8 +13,14 @@ void lowerGoalRush() {
         base.moveForward(4.00_ft);
     }
 
+    // the rush decides the auton, end the robustness trial here rather than after holding until the period ends
+    if (!lift.isClamping()) { // the clamp action runs 0.75 ft from the goal, the rush stopped short
+        RobustnessTrial::fail("goal rush stopped short");
+    }
+    RobustnessTrial::end();
+
     if (!targetRings) {
-        base.moveTo(9_ft, 1.8_ft, Drivetrain::defaultLinearExit<0, 0, 0, 0, 15000, 15000>);
+        base.moveTo(9_ft, 1.8_ft, Drivetrain::linearExit(0, 0, 0, 0, 15000, 15000));
     }
 
     base.moveTo(9_ft, 2.5_ft);
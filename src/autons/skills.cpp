@@ -1,34 +1,44 @@
 #include "autonomous.hpp"
 
-#define releaseMogoMotion()                     \
-    lift.release(); pros::delay(200);           \
-    lift.setSubposition(Subposition::neutral);  \
-    base.endEarly(1_in);                        \
-    base.moveForward(-0.75_ft)
-
-#define transfer()                      \
-    lift.lower();                       \
-    base.turnTo(180_deg);               \
-    holder.release();                   \
-    base.endEarly(0.25_ft);             \
-    base.moveForward(1_ft, false);      \
-    base.endTurnEarly(5_deg);           \
-    base.turnTo(0_deg);                 \
-    base.endEarly(0.25_ft);             \
-    base.addAction(lift.clamp, 0.5_ft); \
-    base.moveForward(1.25_ft);           \
-    lift.raise();
+// release the mogo on the lift, then back away from it
+static CommandPtr releaseMogoMotion() {
+    return sequence({
+        instant(lift.release, {Subsystem::lift}),
+        waitFor(200),
+        instant([]{ lift.setSubposition(Subposition::neutral); }, {Subsystem::lift}),
+        motion([]{ base.endEarly(1_in); return base.moveForwardAsync(-0.75_ft); })
+    });
+}
+
+// move the mogo in the holder to the lift
+static CommandPtr transfer() {
+    return sequence({
+        instant(lift.lower, {Subsystem::lift}),
+        motion([]{ return base.turnToAsync(180_deg); }),
+        instant(holder.release, {Subsystem::holder}),
+        motion([]{ base.endEarly(0.25_ft); return base.moveForwardAsync(1_ft, false); }),
+        motion([]{ base.endTurnEarly(5_deg); return base.turnToAsync(0_deg); }),
+        motion([]{ base.endEarly(0.25_ft); base.addAction(lift.clamp, 0.5_ft); return base.moveForwardAsync(1.25_ft); }),
+        instant(lift.raise, {Subsystem::lift})
+    });
+}
 
 void skills() {
 
-    LinearExitConditions quickLinearExit = Drivetrain::defaultLinearExit<1000, 1000, 1000, 2000, 0, 1500>;
+    LinearExitConditions quickLinearExit = Drivetrain::linearExit(1, 1, 1, 2, 0, 1500);
 
     base.setPosition(28.5_in, 1_ft, 180_deg);
 
+    // back up to the alliance mogo, stopping once the tracked x reaches it
+    // relocalization only corrects y here (the left sensor faces the y = 0 wall, no sensor faces an x wall),
+    // and is turned off before driving next to goals
+    base.setRelocalization(true);
     base.limitSpeed(20);
-    do {
-        base.moveForward(-6_in);
-    } while (30.5 - base.getPosition().x > 0.25);
+    base.setFollowDirection(Direction::reverse);
+    base.moveTo(30.5_in, 1_ft, Drivetrain::linearExit(0.25).withCondition([](const ExitConditions::Sample&){
+        return base.getPosition().x >= 30.25_in;
+    }));
+    base.setRelocalization(false);
 
     holder.grab();
     lift.release();
@@ -63,7 +73,7 @@ void skills() {
     lift.setSubposition(Subposition::low);
     pros::delay(1200);
     intake.reverse();
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
     // get dropped alliance mogo, place on platform
     /*base.limitLinearSpeed(40);
@@ -74,7 +84,7 @@ void skills() {
     base.addAction(lift.clamp, 0.75_ft);
     base.moveTo(3_ft, 9.5_ft);*/
     intake.stop();
-    transfer();
+    CommandScheduler::runUntilFinished(transfer());
     pros::delay(200);
     base.limitLinearSpeed(30);
     base.endTurnEarly(10_deg);
@@ -82,7 +92,7 @@ void skills() {
     base.moveForward(1_ft, false, quickLinearExit);
     lift.setSubposition(Subposition::low);
     pros::delay(200);
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
     base.unboundLinearSpeed();
 
@@ -146,7 +156,7 @@ void skills() {
     base.moveForward(1_ft, false, quickLinearExit);
     lift.setSubposition(Subposition::low);
     pros::delay(250);
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
     // get alliance mogo, rightmost neutral mogo
     base.unboundLinearSpeed();
@@ -156,7 +166,7 @@ void skills() {
     base.turnTo(180_deg);
 
     base << Waypoint {11.25_ft, 3_ft};
-    base.moveTo(11.25_ft, 3_ft, Drivetrain::defaultLinearExit<1000, 50000, 10000, 200000, 150, 200>);
+    base.moveTo(11.25_ft, 3_ft, Drivetrain::linearExit(1, 50, 10, 200, 150, 200));
     holder.grab();
     pros::delay(500);
 
@@ -204,7 +214,7 @@ void skills() {
     // lift.setSubposition(Subposition::low);
     // pros::delay(200);
     intake.reverse();
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
     // drop alliance mogo, place on platform
     lift.lower();
@@ -229,7 +239,7 @@ void skills() {
     base.moveForward(1.15_ft, false, quickLinearExit);
     lift.setSubposition(Subposition::low);
     base.limitLinearSpeed(40);
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
     // get final alliance mogo
     base.setFollowDirection(Direction::reverse);
@@ -278,14 +288,20 @@ void skills() {
 #ifdef _COMMENT_
 void skills2() {
 
-    LinearExitConditions quickLinearExit = Drivetrain::defaultLinearExit<1000, 1000, 1000, 2000, 0, 1500>;
+    LinearExitConditions quickLinearExit = Drivetrain::linearExit(1, 1, 1, 2, 0, 1500);
 
     base.setPosition(28.5_in, 1_ft, 180_deg);
 
+    // back up to the alliance mogo, stopping once the tracked x reaches it
+    // relocalization only corrects y here (the left sensor faces the y = 0 wall, no sensor faces an x wall),
+    // and is turned off before driving next to goals
+    base.setRelocalization(true);
     base.limitSpeed(20);
-    do {
-        base.moveForward(-6_in);
-    } while (30.5 - base.getPosition().x > 0.25);
+    base.setFollowDirection(Direction::reverse);
+    base.moveTo(30.5_in, 1_ft, Drivetrain::linearExit(0.25).withCondition([](const ExitConditions::Sample&){
+        return base.getPosition().x >= 30.25_in;
+    }));
+    base.setRelocalization(false);
 
     holder.grab();
     lift.release();
@@ -320,7 +336,7 @@ void skills2() {
     lift.setSubposition(Subposition::low);
     pros::delay(1200);
     intake.reverse();
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
     // get dropped alliance mogo, place on platform
     /*base.limitLinearSpeed(40);
@@ -331,7 +347,7 @@ void skills2() {
     base.addAction(lift.clamp, 0.75_ft);
     base.moveTo(3_ft, 9.5_ft);*/
     intake.stop();
-    transfer();
+    CommandScheduler::runUntilFinished(transfer());
     pros::delay(200);
     base.limitLinearSpeed(30);
     base.endTurnEarly(10_deg);
@@ -339,7 +355,7 @@ void skills2() {
     base.moveForward(0.75_ft, false, quickLinearExit);
     lift.setSubposition(Subposition::low);
     pros::delay(200);
-    releaseMogoMotion();
+    CommandScheduler::runUntilFinished(releaseMogoMotion());
 
 
     base.limitLinearSpeed(40);
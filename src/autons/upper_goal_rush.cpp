@@ -1,5 +1,13 @@
 #include "autonomous.hpp"
 
+// the rush decides the auton, end the robustness trial once it is done rather than after holding until the period ends
+static void endRushTrial() {
+    if (!lift.isClamping()) { // the clamp action runs 0.75 ft from the goal, the rush stopped short
+        RobustnessTrial::fail("goal rush stopped short");
+    }
+    RobustnessTrial::end();
+}
+
 void upperGoalRush() {
 
     base.setPosition(2_ft, 1.5_ft, 70_deg);
@@ -10,8 +18,9 @@ void upperGoalRush() {
         base.addAction(lift.clamp, 0.75_ft);
         base.endEarly(0.5_ft);
         base.moveForward(4.2_ft);
+        endRushTrial();
         lift.lower();
-        base.moveForward(-4.25_ft, true, Drivetrain::defaultLinearExit<0, 0, 0, 0, 15000, 15000>);
+        base.moveForward(-4.25_ft, true, Drivetrain::linearExit(0, 0, 0, 0, 15000, 15000));
 
     } else {
 
@@ -19,11 +28,12 @@ void upperGoalRush() {
         base.addAction(lift.clamp, 0.75_ft);
         base.endEarly(0.5_ft);
         base.moveForward(4.2_ft);
+        endRushTrial();
         lift.lower();
         base.addAction(lift.release, 1_ft);
-        base.moveTo(1.5_ft, 1.3_ft, [](long double curDist, bool, bool){
-            return (curDist < 4_in);
-        });
+        base.moveTo(1.5_ft, 1.3_ft, ExitConditions {}.withCondition([](const ExitConditions::Sample& sample){
+            return (sample.error < 4_in);
+        }));
         lift.release();
         base.moveTo(1.5_ft, 1.3_ft);
         base.turnTo(160_deg);
@@ -52,7 +62,7 @@ void upperGoalRush() {
     base.setLinearSlew(0);
 
     if (!targetRings) {
-        base.moveForward(-3_ft, true, Drivetrain::defaultLinearExit<0, 0, 0, 0, 15000, 15000>);
+        base.moveForward(-3_ft, true, Drivetrain::linearExit(0, 0, 0, 0, 15000, 15000));
     }
 
     base.moveForward(-2_ft);
@@ -4,26 +4,32 @@ void upperRing() {
 
     base.setPosition(targetTallNeutralMogo ? 22.5_in : 24_in, 1_ft, 0_deg);
 
-    lift.setManualControl(true);
-
-    lift.motor.move(75);
-    do {
-        pros::delay(10);
-    } while (lift.motor.get_position() < 200);
-    lift.release();
-    pros::delay(200);
-
-    lift.setManualControl(false);
-    pros::delay(250);
+    // raise the lift, then release the claw
+    CommandScheduler::runUntilFinished(sequence({
+        functional(
+            []{ lift.setManualControl(true); lift.motor.move(75); },
+            {},
+            []{ return SensorHub::getSnapshot().liftPosition >= 200; },
+            [](bool){ lift.release(); },
+            {Subsystem::lift}
+        ),
+        waitFor(200),
+        instant([]{ lift.setManualControl(false); }, {Subsystem::lift}),
+        waitFor(250)
+    }));
 
     base.endEarly(0.5_ft);
     base.moveForward(-1.5_ft);
 
     base.moveTo(2.5_ft, 57_in, goalRushExitConditions);
+    if (base.getPosition().y < 56_in) { // neither position condition was met, the rush timed out short of the goal
+        RobustnessTrial::fail("goal rush timed out");
+    }
     lift.clamp();
+    RobustnessTrial::end(); // the rush decides the auton, the bot then holds until the period ends
 
     base.setLinearSlew(0);
 
-    base.moveForward(-3_ft, true, Drivetrain::defaultLinearExit<0, 0, 0, 0, 15000, 15000>);
+    base.moveForward(-3_ft, true, Drivetrain::linearExit(0, 0, 0, 0, 15000, 15000));
 
 }
\ No newline at end of file
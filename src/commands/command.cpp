@@ -0,0 +1,140 @@
+#include "commands/command.hpp"
+#include "systems.hpp"
+
+namespace commands {
+
+    /**
+     * Command
+     */
+
+    // constructor, subsystems are the subsystems the command controls
+    Command::Command(std::initializer_list<Subsystem> subsystems) : requirements {0} {
+        for (Subsystem subsystem : subsystems) {
+            requirements |= static_cast<Requirements>(subsystem);
+        }
+    }
+
+    void Command::initialize() {}
+
+    void Command::execute() {}
+
+    void Command::end(bool) {}
+
+    // returns the subsystems the command controls
+    Requirements Command::getRequirements() const {
+        return requirements;
+    }
+
+    /**
+     * InstantCommand
+     */
+
+    InstantCommand::InstantCommand(std::function<void()> action, std::initializer_list<Subsystem> subsystems)
+        : Command {subsystems}, action {std::move(action)} {}
+
+    void InstantCommand::initialize() {
+        action();
+    }
+
+    bool InstantCommand::isFinished() {
+        return true;
+    }
+
+    /**
+     * WaitCommand
+     */
+
+    WaitCommand::WaitCommand(uint32_t time) : time {time} {}
+
+    void WaitCommand::initialize() {
+        startTime = pros::millis();
+    }
+
+    bool WaitCommand::isFinished() {
+        return pros::millis() - startTime >= time;
+    }
+
+    /**
+     * WaitUntilCommand
+     */
+
+    WaitUntilCommand::WaitUntilCommand(std::function<bool()> condition) : condition {std::move(condition)} {}
+
+    bool WaitUntilCommand::isFinished() {
+        return condition();
+    }
+
+    /**
+     * FunctionalCommand
+     */
+
+    FunctionalCommand::FunctionalCommand(
+        std::function<void()> onInitialize, std::function<void()> onExecute,
+        std::function<bool()> onIsFinished, std::function<void(bool)> onEnd,
+        std::initializer_list<Subsystem> subsystems
+    ) :
+        Command {subsystems}, onInitialize {std::move(onInitialize)}, onExecute {std::move(onExecute)},
+        onIsFinished {std::move(onIsFinished)}, onEnd {std::move(onEnd)}
+    {}
+
+    void FunctionalCommand::initialize() {
+        if (onInitialize) {
+            onInitialize();
+        }
+    }
+
+    void FunctionalCommand::execute() {
+        if (onExecute) {
+            onExecute();
+        }
+    }
+
+    // without an isFinished function, the command runs until it is interrupted
+    bool FunctionalCommand::isFinished() {
+        return onIsFinished && onIsFinished();
+    }
+
+    void FunctionalCommand::end(bool interrupted) {
+        if (onEnd) {
+            onEnd(interrupted);
+        }
+    }
+
+    /**
+     * MotionCommand
+     */
+
+    MotionCommand::MotionCommand(std::function<Drivetrain::MotionHandle()> startMotion, scalar_t stopError)
+        : Command {Subsystem::drivetrain}, startMotion {std::move(startMotion)}, stopError {stopError} {}
+
+    void MotionCommand::initialize() {
+        handle = startMotion();
+    }
+
+    bool MotionCommand::isFinished() {
+        // getError is NAN until the motion starts, so the comparison is false while it is queued
+        return handle.isDone() || handle.getError() <= stopError;
+    }
+
+    // stops the motion if it is still running, either interrupted or stopped early at stopError
+    void MotionCommand::end(bool) {
+        if (!handle.isDone()) {
+            handle.cancel();
+        }
+    }
+
+    /**
+     * LiftCommand
+     */
+
+    LiftCommand::LiftCommand(std::function<void()> setState) : Command {Subsystem::lift}, setState {std::move(setState)} {}
+
+    void LiftCommand::initialize() {
+        setState();
+    }
+
+    bool LiftCommand::isFinished() {
+        return motor_control::Lift::isSettled();
+    }
+
+} // namespace commands
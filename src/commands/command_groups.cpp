@@ -0,0 +1,110 @@
+#include "commands/command_groups.hpp"
+
+namespace commands {
+
+    /**
+     * SequentialGroup
+     */
+
+    SequentialGroup::SequentialGroup(std::initializer_list<CommandPtr> commands) : commands {commands} {
+        for (const CommandPtr& command : commands) {
+            requirements |= command->getRequirements();
+        }
+    }
+
+    void SequentialGroup::initialize() {
+        current = 0;
+        if (!commands.empty()) {
+            commands[0]->initialize();
+        }
+    }
+
+    // runs the current command, starting the next one (executed next tick) when it finishes
+    void SequentialGroup::execute() {
+        if (current == commands.size()) {
+            return;
+        }
+        commands[current]->execute();
+        if (commands[current]->isFinished()) {
+            commands[current]->end(false);
+            ++current;
+            if (current < commands.size()) {
+                commands[current]->initialize();
+            }
+        }
+    }
+
+    bool SequentialGroup::isFinished() {
+        return current == commands.size();
+    }
+
+    void SequentialGroup::end(bool interrupted) {
+        if (interrupted && current < commands.size()) {
+            commands[current]->end(true);
+        }
+    }
+
+    /**
+     * ParallelGroup
+     */
+
+    ParallelGroup::ParallelGroup(Mode mode, std::initializer_list<CommandPtr> commands)
+        : mode {mode}, commands {commands}, running(commands.size(), false)
+    {
+        for (const CommandPtr& command : commands) {
+            requirements |= command->getRequirements();
+        }
+    }
+
+    void ParallelGroup::initialize() {
+        for (size_t i = 0; i < commands.size(); ++i) {
+            commands[i]->initialize();
+            running[i] = true;
+        }
+    }
+
+    // runs every running command, ending the ones that finish
+    void ParallelGroup::execute() {
+        for (size_t i = 0; i < commands.size(); ++i) {
+            if (running[i]) {
+                commands[i]->execute();
+                if (commands[i]->isFinished()) {
+                    commands[i]->end(false);
+                    running[i] = false;
+                }
+            }
+        }
+    }
+
+    bool ParallelGroup::isFinished() {
+        switch (mode) {
+            case Mode::race:
+                for (size_t i = 0; i < commands.size(); ++i) {
+                    if (!running[i]) {
+                        return true;
+                    }
+                }
+                return commands.empty();
+            case Mode::deadline:
+                return commands.empty() || !running[0];
+            default: // all
+                for (size_t i = 0; i < commands.size(); ++i) {
+                    if (running[i]) {
+                        return false;
+                    }
+                }
+                return true;
+        }
+    }
+
+    // interrupts the commands that are still running
+    void ParallelGroup::end(bool) {
+        for (size_t i = 0; i < commands.size(); ++i) {
+            if (running[i]) {
+                commands[i]->end(true);
+                running[i] = false;
+            }
+        }
+    }
+
+} // namespace commands
@@ -0,0 +1,81 @@
+#include "commands/command_scheduler.hpp"
+
+#include <algorithm>
+
+namespace commands {
+
+    std::vector<CommandPtr> CommandScheduler::commands {};
+
+    // Initializes command and runs it every tick until it finishes
+    // Running commands that require any of the same subsystems are interrupted
+    void CommandScheduler::schedule(const CommandPtr& command) {
+
+        if (!command || isScheduled(command)) {
+            return;
+        }
+
+        for (size_t i = 0; i < commands.size();) {
+            if (commands[i]->getRequirements() & command->getRequirements()) {
+                CommandPtr interrupted = commands[i];
+                commands.erase(commands.begin() + i);
+                interrupted->end(true);
+            } else {
+                ++i;
+            }
+        }
+
+        commands.push_back(command);
+        command->initialize();
+
+    }
+
+    // Interrupts command if it is running
+    void CommandScheduler::cancel(const CommandPtr& command) {
+        auto found = std::find(commands.begin(), commands.end(), command);
+        if (found != commands.end()) {
+            commands.erase(found);
+            command->end(true);
+        }
+    }
+
+    // Interrupts every running command
+    void CommandScheduler::cancelAll() {
+        while (!commands.empty()) {
+            cancel(commands.front());
+        }
+    }
+
+    // Returns true if command is running
+    bool CommandScheduler::isScheduled(const CommandPtr& command) {
+        return std::find(commands.begin(), commands.end(), command) != commands.end();
+    }
+
+    // Runs one tick: executes every running command, then ends the commands that have finished
+    void CommandScheduler::run() {
+
+        // commands scheduled or cancelled by a running command change the vector, so iterate over a copy
+        std::vector<CommandPtr> tick = commands;
+        for (const CommandPtr& command : tick) {
+            if (!isScheduled(command)) {
+                continue; // interrupted earlier in this tick
+            }
+            command->execute();
+            if (command->isFinished()) {
+                commands.erase(std::find(commands.begin(), commands.end(), command));
+                command->end(false);
+            }
+        }
+
+    }
+
+    // Schedules command, then runs ticks every period until it finishes, other scheduled commands keep running
+    void CommandScheduler::runUntilFinished(const CommandPtr& command) {
+        schedule(command);
+        while (isScheduled(command)) {
+            uint32_t startTime = pros::millis();
+            run();
+            pros::Task::delay_until(&startTime, period);
+        }
+    }
+
+} // namespace commands
@@ -0,0 +1,72 @@
+#include "commands.hpp"
+
+namespace commands {
+
+    // runs action once, requiring subsystems
+    CommandPtr instant(std::function<void()> action, std::initializer_list<Subsystem> subsystems) {
+        return std::make_shared<InstantCommand>(std::move(action), subsystems);
+    }
+
+    // runs the given functions as a command, see FunctionalCommand
+    CommandPtr functional(
+        std::function<void()> initialize, std::function<void()> execute,
+        std::function<bool()> isFinished, std::function<void(bool)> end,
+        std::initializer_list<Subsystem> subsystems
+    ) {
+        return std::make_shared<FunctionalCommand>(
+            std::move(initialize), std::move(execute), std::move(isFinished), std::move(end), subsystems
+        );
+    }
+
+    // waits time milliseconds
+    CommandPtr waitFor(uint32_t time) {
+        return std::make_shared<WaitCommand>(time);
+    }
+
+    // waits until condition returns true
+    CommandPtr waitUntil(std::function<bool()> condition) {
+        return std::make_shared<WaitUntilCommand>(std::move(condition));
+    }
+
+    // queues the motion started by startMotion (an Async movement function) and waits for it to finish
+    CommandPtr motion(std::function<Drivetrain::MotionHandle()> startMotion) {
+        return std::make_shared<MotionCommand>(std::move(startMotion));
+    }
+
+    // queues the motion started by startMotion and waits until its error is within stopError, then stops it
+    CommandPtr motionWithin(std::function<Drivetrain::MotionHandle()> startMotion, scalar_t stopError) {
+        return std::make_shared<MotionCommand>(std::move(startMotion), stopError);
+    }
+
+    // requests a lift state with setState and waits for the lift to settle
+    CommandPtr liftTo(std::function<void()> setState) {
+        return std::make_shared<LiftCommand>(std::move(setState));
+    }
+
+    // runs commands one after another
+    CommandPtr sequence(std::initializer_list<CommandPtr> commands) {
+        return std::make_shared<SequentialGroup>(commands);
+    }
+
+    // runs commands at the same time until all have finished
+    CommandPtr parallel(std::initializer_list<CommandPtr> commands) {
+        return std::make_shared<ParallelGroup>(ParallelGroup::Mode::all, commands);
+    }
+
+    // runs commands at the same time until any has finished
+    CommandPtr race(std::initializer_list<CommandPtr> commands) {
+        return std::make_shared<ParallelGroup>(ParallelGroup::Mode::race, commands);
+    }
+
+    // runs deadline and commands at the same time until deadline has finished
+    CommandPtr deadline(const CommandPtr& deadline, std::initializer_list<CommandPtr> commands) {
+        // the other commands run as one group, so the deadline is always the group's first command
+        return std::make_shared<ParallelGroup>(ParallelGroup::Mode::deadline, std::initializer_list<CommandPtr> {deadline, parallel(commands)});
+    }
+
+    // runs command until it finishes or time milliseconds pass
+    CommandPtr withTimeout(const CommandPtr& command, uint32_t time) {
+        return race({command, waitFor(time)});
+    }
+
+} // namespace commands
@@ -12,18 +12,32 @@
 // Easier reversing of the drivetrain (change 1 line instead of 6)
 constexpr bool REVERSED_SET = false;
 
-pros::Motor Drivetrain::frontLeftMotor          {18, pros::E_MOTOR_GEARSET_06, REVERSED_SET};
-pros::Motor Drivetrain::topBackLeftMotor        {20, pros::E_MOTOR_GEARSET_06, !REVERSED_SET};
-pros::Motor Drivetrain::bottomBackLeftMotor     {19, pros::E_MOTOR_GEARSET_06, REVERSED_SET};
-pros::Motor Drivetrain::frontRightMotor         {6, pros::E_MOTOR_GEARSET_06, !REVERSED_SET};
-pros::Motor Drivetrain::topBackRightMotor       {9, pros::E_MOTOR_GEARSET_06, REVERSED_SET};
-pros::Motor Drivetrain::bottomBackRightMotor    {7, pros::E_MOTOR_GEARSET_06, !REVERSED_SET};
+motor_control::CachedMotor Drivetrain::frontLeftMotor       {18, pros::E_MOTOR_GEARSET_06, REVERSED_SET};
+motor_control::CachedMotor Drivetrain::topBackLeftMotor     {20, pros::E_MOTOR_GEARSET_06, !REVERSED_SET};
+motor_control::CachedMotor Drivetrain::bottomBackLeftMotor  {19, pros::E_MOTOR_GEARSET_06, REVERSED_SET};
+motor_control::CachedMotor Drivetrain::frontRightMotor      {6, pros::E_MOTOR_GEARSET_06, !REVERSED_SET};
+motor_control::CachedMotor Drivetrain::topBackRightMotor    {9, pros::E_MOTOR_GEARSET_06, REVERSED_SET};
+motor_control::CachedMotor Drivetrain::bottomBackRightMotor {7, pros::E_MOTOR_GEARSET_06, !REVERSED_SET};
 
 pros::Imu Drivetrain::imu1 {11};
 pros::Imu Drivetrain::imu2 {12};
 
-pros::ADIEncoder Drivetrain::parallelTrackingWheel      {'E', 'F', true};
-pros::ADIEncoder Drivetrain::perpendicularTrackingWheel {'A', 'B', true};
+#ifdef ROTATION_SENSOR_ODOMETRY
+static Drivetrain::RotationTrackingWheels rotationTrackingWheels {4, 5, true}; // parallel, perpendicular ports
+Drivetrain::TrackingWheels& Drivetrain::trackingWheels = rotationTrackingWheels;
+#else
+static Drivetrain::ADITrackingWheels adiTrackingWheels {'E', 'F', 'A', 'B', true}; // parallel, perpendicular ports
+Drivetrain::TrackingWheels& Drivetrain::trackingWheels = adiTrackingWheels;
+#endif
+
+// PLACEHOLDER ports, not yet wired: match the ports (and the mounts in src/drivetrain/constants.cpp) to the bot
+pros::Distance Drivetrain::leftDistanceSensor {1};
+pros::Distance Drivetrain::backDistanceSensor {2};
+
+// the offset (m) of the GPS from the tracking center, x to the right and y forward, so it reports the tracking center
+// PLACEHOLDER offset, not yet measured: replace with the mount of the GPS on the bot
+// the GPS axes are mapped to the field axes with Drivetrain::gpsFieldRotation (src/drivetrain/constants.cpp)
+pros::Gps Drivetrain::gps {3, 0.0, 0.0};
 
 /*
  * Non Drivetrain Devices
@@ -32,9 +46,9 @@ namespace motor_control {
 
     pros::ADIDigitalOut Holder::clamp {'D'};
 
-    pros::Motor Intake::motor {8, pros::E_MOTOR_GEARSET_06, true};
+    CachedMotor Intake::motor {8, pros::E_MOTOR_GEARSET_06, true};
 
-    pros::Motor         Lift::motor   {10, pros::E_MOTOR_GEARSET_36, false};
+    CachedMotor         Lift::motor   {10, pros::E_MOTOR_GEARSET_36, false};
     pros::ADIDigitalOut Lift::claw    {'C'};
 
 } // namespace motor_control
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "drivetrain.hpp"
+#include "pros/rtos.h"
+#include "pros/rtos.hpp"
+
+#include <cmath>
+
+/**
+ * This file contains the motion queue used by the asynchronous movement functions
+ *
+ * Queued motions are executed, in order, by the drive task (src/util/task_manager.cpp)
+ * The blocking movement functions are reused, so async motions behave exactly like their blocking counterparts
+ *
+ * Consecutive queued motions that only drive to a point (moveToAsync without a heading, moveForwardAsync, followAsync(Waypoint),
+ * followAsync(PurePursuitPath))
+ * are blended: the first hands off to the next near its target without zeroing the motors,
+ * and the next continues the PID state rather than resetting it
+ */
+
+// task that executes queued motions, defined in src/util/task_manager.cpp
+extern pros::Task driveTask;
+
+/**
+ * Motion queue initialization
+ */
+
+pros::Mutex Drivetrain::motionQueueMutex {};
+
+std::vector<Drivetrain::Action> Drivetrain::queuedActions {};
+
+Drivetrain::MotionCommand Drivetrain::motionQueue[Drivetrain::motionQueueCapacity] {};
+size_t Drivetrain::motionQueueStart     = 0;
+size_t Drivetrain::motionQueueLength    = 0;
+
+std::shared_ptr<Drivetrain::MotionState> Drivetrain::currentMotion {nullptr};
+bool Drivetrain::runningQueuedMotion = false;
+
+bool Drivetrain::blendingOut    = false;
+bool Drivetrain::blendingIn     = false;
+
+/**
+ * MotionHandle
+ */
+
+// constructs an empty handle that refers to no motion (is considered completed)
+Drivetrain::MotionHandle::MotionHandle() : state {nullptr} {}
+
+// constructor used by Drivetrain when queueing a motion
+Drivetrain::MotionHandle::MotionHandle(std::shared_ptr<MotionState> state) : state {std::move(state)} {}
+
+// Blocks the calling task until the motion is no longer queued or running, or until timeout milliseconds pass
+bool Drivetrain::MotionHandle::wait(uint32_t timeout) const {
+    uint32_t startTime = pros::millis();
+    while (!isDone()) {
+        if (timeout != TIMEOUT_MAX && pros::millis() - startTime >= timeout) {
+            return false; // timed out before the motion finished
+        }
+        pros::delay(10); // delay task
+    }
+    return true;
+}
+
+// Returns true if the motion is no longer queued or running
+bool Drivetrain::MotionHandle::isDone() const {
+    Status status = getStatus();
+    return status != Status::queued && status != Status::running;
+}
+
+// Returns the current state of the motion
+Drivetrain::MotionHandle::Status Drivetrain::MotionHandle::getStatus() const {
+    if (!state) {
+        return Status::completed; // empty handles refer to no motion
+    }
+motionQueueMutex.take();
+    Status status = state->status;
+motionQueueMutex.give();
+    return status;
+}
+
+// Returns the remaining error of the motion as of the last control loop
+scalar_t Drivetrain::MotionHandle::getError() const {
+    if (!state) {
+        return NAN;
+    }
+motionQueueMutex.take();
+    scalar_t error = state->error;
+motionQueueMutex.give();
+    return error;
+}
+
+// Cancels the motion: a queued motion is skipped, a running motion is stopped as if stopMotion was called
+void Drivetrain::MotionHandle::cancel() {
+    if (!state) {
+        return;
+    }
+motionQueueMutex.take();
+    if (state->status == Status::running) {
+        stopped = true; // stop the motion during its next control loop
+        blendingOut = false; // stop the motors rather than handing off
+        state->status = Status::cancelled;
+    } else if (state->status == Status::queued) {
+        state->status = Status::cancelled; // the drive task will skip the motion
+    }
+motionQueueMutex.give();
+}
+
+/**
+ * Asynchronous movement functions
+ */
+
+Drivetrain::MotionHandle Drivetrain::moveToAsync(
+    scalar_t x, scalar_t y, scalar_t heading,
+    LinearExitConditions linearExitConditions, TurnExitConditions turnExitConditions
+) {
+    return queueMotion([=]{ moveTo(x, y, heading, linearExitConditions, turnExitConditions); }, std::isnan(heading));
+}
+
+Drivetrain::MotionHandle Drivetrain::moveToAsync(
+    scalar_t x, scalar_t y, XYPoint targetForHeading,
+    LinearExitConditions linearExitConditions, TurnExitConditions turnExitConditions
+) {
+    return queueMotion([=]{ moveTo(x, y, targetForHeading, linearExitConditions, turnExitConditions); });
+}
+
+Drivetrain::MotionHandle Drivetrain::moveToAsync(scalar_t x, scalar_t y, LinearExitConditions linearExitConditions) {
+    return queueMotion([=]{ moveTo(x, y, linearExitConditions); }, true);
+}
+
+Drivetrain::MotionHandle Drivetrain::turnToAsync(scalar_t heading, TurnExitConditions exitConditions) {
+    return queueMotion([=]{ turnTo(heading, exitConditions); });
+}
+
+Drivetrain::MotionHandle Drivetrain::turnToAsync(XYPoint target, bool absolute, TurnExitConditions exitConditions) {
+    return queueMotion([=]{ turnTo(target, absolute, exitConditions); });
+}
+
+Drivetrain::MotionHandle Drivetrain::moveForwardAsync(scalar_t dist, bool absolute, LinearExitConditions exitConditions) {
+    return queueMotion([=]{ moveForward(dist, absolute, exitConditions); }, true);
+}
+
+// Queues a pure pursuit movement to the Waypoint
+Drivetrain::MotionHandle Drivetrain::followAsync(const Waypoint& p) {
+    return queueMotion([p]{ drive::base << p; }, true);
+}
+
+// Queues a pure pursuit movement along the PurePursuitPath
+Drivetrain::MotionHandle Drivetrain::followAsync(const PurePursuitPath& path) {
+    return queueMotion([path]{ drive::base << path; }, true);
+}
+
+// Queues following the motion profile stored in the Path
+// std::function requires a copyable callable, so the Path is moved into shared storage
+Drivetrain::MotionHandle Drivetrain::followAsync(Path&& path) {
+    std::shared_ptr<Path> storedPath = std::make_shared<Path>(std::move(path));
+    return queueMotion([storedPath]{ drive::base << *storedPath; });
+}
+
+// Queues an arbitrary sequence of blocking movement calls to be executed as one motion
+Drivetrain::MotionHandle Drivetrain::runAsync(std::function<void()>&& motion) {
+    return queueMotion(std::move(motion));
+}
+
+// Blocks the calling task until every queued motion has finished
+void Drivetrain::waitUntilSettled() {
+    while (true) {
+    motionQueueMutex.take();
+        bool settled = (motionQueueLength == 0 && !currentMotion);
+    motionQueueMutex.give();
+        if (settled) {
+            break;
+        }
+        pros::delay(10); // delay task
+    }
+}
+
+// Cancels the running motion and every queued motion
+void Drivetrain::cancelAllMotions() {
+motionQueueMutex.take();
+    for (size_t i = 0; i < motionQueueLength; ++i) {
+        motionQueue[(motionQueueStart + i) % motionQueueCapacity].state->status = MotionStatus::cancelled;
+    }
+    if (currentMotion) {
+        currentMotion->status = MotionStatus::cancelled;
+        stopped = true;
+        blendingOut = false;
+    }
+motionQueueMutex.give();
+}
+
+/**
+ * Motion queue management
+ */
+
+// Resets stopped, moves queued actions into actionList, updates the speeds PID gains are scheduled by,
+// call at the start of every movement
+void Drivetrain::startMotion() {
+
+    // commanded speeds (inches per second) for gain schedules keyed by speed, read by calcPower at the start of the motion
+    linearPID.setScheduleSpeed(linearSpeedLimit * maxVelocity / 12000);
+    rotPID.setScheduleSpeed(rotSpeedLimit * maxVelocity / 12000);
+
+motionQueueMutex.take();
+    if (runningQueuedMotion) {
+        // actions were bound when the motion was queued, a cancelled motion stays stopped
+        // (so a turnTo invoked by a cancelled moveTo does not run)
+        stopped = (currentMotion && currentMotion->status == MotionStatus::cancelled);
+    } else {
+        stopped = false;
+        for (Action& action : queuedActions) {
+            actionList.push_back(std::move(action));
+        }
+        queuedActions.clear();
+    }
+motionQueueMutex.give();
+}
+
+// Stores an action for the next motion: in actionList if called by the drive task (which executes the motion),
+// otherwise in queuedActions
+void Drivetrain::storeAction(Action&& action) {
+    if (pros::c::task_get_current() == static_cast<pros::task_t>(driveTask)) {
+        // called from within a queued motion (ex: runAsync), the action is for the next movement call of that motion
+        actionList.push_back(std::move(action));
+    } else {
+    motionQueueMutex.take();
+        queuedActions.push_back(std::move(action));
+    motionQueueMutex.give();
+    }
+}
+
+// Adds a motion to the motion queue, binds queued actions to it, and notifies the drive task
+Drivetrain::MotionHandle Drivetrain::queueMotion(std::function<void()>&& motion, bool blendable) {
+
+    std::shared_ptr<MotionState> state = std::make_shared<MotionState>();
+
+motionQueueMutex.take();
+
+    if (motionQueueLength == motionQueueCapacity) { // queue is full, the motion will never run
+        state->status = MotionStatus::rejected;
+        queuedActions.clear(); // actions bound to a motion that will not run are discarded
+    motionQueueMutex.give();
+        return MotionHandle {state};
+    }
+
+    MotionCommand& command = motionQueue[(motionQueueStart + motionQueueLength) % motionQueueCapacity];
+    command.motion = std::move(motion);
+    command.actions = std::move(queuedActions);
+    command.state = state;
+    command.blendable = blendable;
+    queuedActions.clear(); // moved from vectors are valid but unspecified
+    ++motionQueueLength;
+
+motionQueueMutex.give();
+
+    driveTask.notify(); // wake the drive task
+
+    return MotionHandle {state};
+
+}
+
+// Returns true if the running motion should hand off to the next queued motion without stopping
+bool Drivetrain::blendIntoNextMotion() {
+motionQueueMutex.take();
+    bool blending = blendingOut;
+motionQueueMutex.give();
+    return blending;
+}
+
+// Executes motions in the queue until it is empty, called in drive task
+void Drivetrain::runQueuedMotions() {
+
+    // whether the previous motion ended without zeroing the motors
+    bool previousBlendedOut = false;
+
+    while (true) {
+
+        MotionCommand command;
+
+    motionQueueMutex.take();
+
+        if (motionQueueLength == 0) {
+        motionQueueMutex.give();
+            if (previousBlendedOut) { // the motion that was blended into was cancelled, stop the motors
+                supply(0, 0);
+            }
+            break; // nothing left to execute
+        }
+
+        // pop the next motion off of the queue
+        command = std::move(motionQueue[motionQueueStart]);
+        motionQueue[motionQueueStart] = MotionCommand {};
+        motionQueueStart = (motionQueueStart + 1) % motionQueueCapacity;
+        --motionQueueLength;
+
+        if (command.state->status == MotionStatus::cancelled) { // skip motions cancelled while queued
+        motionQueueMutex.give();
+            continue;
+        }
+
+        command.state->status = MotionStatus::running;
+        currentMotion = command.state;
+        runningQueuedMotion = true;
+
+        // look ahead at the next motion to determine if this motion can be blended into it
+        blendingOut = false;
+        if (command.blendable && motionQueueLength > 0) {
+            const MotionCommand& next = motionQueue[motionQueueStart];
+            blendingOut = next.blendable && next.state->status == MotionStatus::queued;
+        }
+
+    motionQueueMutex.give();
+
+        // continue from the previous motion only if it handed off to this one
+        blendingIn = previousBlendedOut && command.blendable;
+        if (previousBlendedOut && !command.blendable) {
+            supply(0, 0);
+        }
+
+        // execute the motion with its bound actions
+        actionList = std::move(command.actions);
+        command.motion();
+
+    motionQueueMutex.take();
+        if (currentMotion->status == MotionStatus::running) {
+            currentMotion->status = MotionStatus::completed;
+        }
+        previousBlendedOut = blendingOut; // false if cancelled
+        blendingOut = false;
+        currentMotion = nullptr;
+        runningQueuedMotion = false;
+    motionQueueMutex.give();
+
+    }
+
+    blendingIn = false;
+
+}
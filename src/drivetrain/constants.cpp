@@ -1,4 +1,5 @@
 #include "drivetrain.hpp"
+#include "util/conversions.hpp"
 
 /**
  * This file contains constants used throughout the Drivetrain class and the algorithms it implements
@@ -13,7 +14,20 @@ motor_control::PIDController Drivetrain::linearPID {
     
     0,  // voltageAcceleration (volts / seconds) ------------ was 16
     12, // maxVoltage           (volts)
-    0   // startingVoltage      (volts)
+    0,  // startingVoltage      (volts)
+
+    0.02,   // derivativeFilterTime (seconds)
+
+    // gains scheduled by the distance (in) of moveTo motions, the 24 in entry matches the constant gains above
+    // stiffer gains overcome friction on short moves, softer gains prevent overshoot on long moves
+    // PLACEHOLDER values, not yet tuned: replace with gains found by sweeping each distance on the field
+    // heading correction and motion profile tracking use the constant gains
+    {motor_control::GainSchedule::Key::motionSize, {
+    //   distance   kP      kD      kI
+        {6,         2.2,    0.1,    0},
+        {24,        1.75,   0.08,   0},
+        {96,        1.4,    0.08,   0}
+    }}
 
 };
 
@@ -26,23 +40,112 @@ motor_control::PIDController Drivetrain::rotPID {
     
     24,  // voltageAcceleration (volts / seconds)
     12, // maxVoltage           (volts)
-    0   // startingVoltage      (volts)
+    0,  // startingVoltage      (volts)
+
+    0.02,   // derivativeFilterTime (seconds)
+
+    // gains scheduled by the angle (deg) of turnTo motions, the 90 deg entry matches the constant gains above
+    // PLACEHOLDER values, not yet tuned: replace with gains found by sweeping each angle on the field
+    // heading correction during drives uses the constant gains
+    {motor_control::GainSchedule::Key::motionSize, {
+    //   angle      kP      kD      kI
+        {15,        1.5,    0.06,   0},
+        {90,        1.1,    0.05,   0},
+        {180,       0.95,   0.05,   0}
+    }}
 
 };
 
-// in inches, pure pursuit and motion profiling error correction constant
-const long double Drivetrain::defaultLookAheadDistance      = 30;
+// pure pursuit and motion profiling error correction look ahead distance
+const Drivetrain::LookAheadPolicy Drivetrain::defaultLookAheadPolicy {
+    
+    12,     // minDistance      (in)
+    36,     // maxDistance      (in)
+    0.4,    // velocityGain     (s)
+    24      // curvatureGain    (in)
+
+};
+// exit conditions used when none are specified (see include/drivetrain/exit_conditions.hpp for the default arguments)
+const Drivetrain::ExitConditions Drivetrain::defaultPurePursuitExit = Drivetrain::purePursuitExit();
+const Drivetrain::ExitConditions Drivetrain::defaultLinearExit      = Drivetrain::linearExit();
+const Drivetrain::ExitConditions Drivetrain::defaultTurnExit        = Drivetrain::turnExit();
+
 // moveTo constant, prevents turning when very close to target
 // (so the bot does not turn if very slightly to the side of the target)
-const long double Drivetrain::minDistForTurning             = 5;
+const scalar_t Drivetrain::minDistForTurning             = 5;
+// in inches, blended moveTo motions hand off to the next queued motion once this close to their target
+const scalar_t Drivetrain::blendDistance                 = 6;
 
 /* odometry constants, all in inches */
-const long double Drivetrain::wheelSpacingParallel          = 1.75;
-const long double Drivetrain::wheelSpacingPerpendicular     = -0.1;
-const long double Drivetrain::trackingWheelDiameter         = 2.81;
+const scalar_t Drivetrain::wheelSpacingParallel          = 1.75;
+const scalar_t Drivetrain::wheelSpacingPerpendicular     = -0.1;
+const scalar_t Drivetrain::trackingWheelDiameter         = 2.81;
+const scalar_t Drivetrain::driveWheelDiameter            = 3.25;
+const scalar_t Drivetrain::driveGearRatio                = 0.6; // wheel rotations / motor rotation
+const scalar_t Drivetrain::fieldLength                   = 144; // field walls are at 0 and fieldLength in x and y
+// PLACEHOLDER, not yet checked on a field: drive along the field x axis and see which way the GPS x reading moves
+const scalar_t Drivetrain::gpsFieldRotation              = 0;   // radians, GPS x axis points along the field x axis
+
+/* distance sensor relocalization constants */
+// PLACEHOLDER mounts, not yet measured: replace with the offsets of the sensors on the bot before enabling relocalization
+const Drivetrain::DistanceSensorMount Drivetrain::leftDistanceSensorMount {
+    -2,     // forwardOffset    (in)
+    6.5,    // leftOffset       (in)
+    conversions::pi / 2     // angle    (radians), faces left
+};
+const Drivetrain::DistanceSensorMount Drivetrain::backDistanceSensorMount {
+    -7,     // forwardOffset    (in)
+    0,      // leftOffset       (in)
+    conversions::pi         // angle    (radians), faces backward
+};
+// the distance sensors update about every 33 ms, so only correct every few odometry updates to avoid reusing the same reading
+const uint32_t Drivetrain::relocalizationPeriod          = 40;   // ms
+
+/* particle filter constants */
+const scalar_t Drivetrain::initialParticleSpread         = 2;    // in
+const scalar_t Drivetrain::initialParticleHeadingSpread  = 0.05; // radians (about 3 deg)
+const scalar_t Drivetrain::maxParticleSpread             = 3;    // in
+const scalar_t Drivetrain::minParticleSpread             = 0.5;  // in
+const scalar_t Drivetrain::particleVarianceInflation     = 4;
+
+// time constant (seconds) of the low pass filter on the published accelerations (differences of the velocities are noisy)
+const scalar_t Drivetrain::accelerationFilterTime        = 0.05;
+
+const scalar_t Drivetrain::ParticleFilter::motionNoiseRatio          = 0.05;     // in / in traveled
+const scalar_t Drivetrain::ParticleFilter::motionNoiseFloor          = 0.05;     // in, per prediction
+const scalar_t Drivetrain::ParticleFilter::headingNoiseRatio         = 0.05;     // radians / radian turned
+const scalar_t Drivetrain::ParticleFilter::headingNoiseFloor         = 0.002;    // radians, per prediction
+const scalar_t Drivetrain::ParticleFilter::wallDistanceNoise         = 0.5;      // in
+const scalar_t Drivetrain::ParticleFilter::wallDistanceNoiseRatio    = 0.03;     // in / in of the reading
+const scalar_t Drivetrain::ParticleFilter::outlierProbability        = 0.2;
+
+/* pose estimator (extended Kalman filter) noise constants, standard deviations */
+const scalar_t Drivetrain::PoseEstimator::accelerationNoise          = 60;       // in / s^2
+const scalar_t Drivetrain::PoseEstimator::lateralAccelerationNoise   = 20;       // in / s^2 (sideways sliding)
+const scalar_t Drivetrain::PoseEstimator::angularAccelerationNoise   = 10;       // radians / s^2
+const scalar_t Drivetrain::PoseEstimator::imuBiasDrift               = 0.002;    // radians / sqrt(s)
+const scalar_t Drivetrain::PoseEstimator::positionDrift              = 0.25;     // in / sqrt(s)
+const scalar_t Drivetrain::PoseEstimator::trackingWheelNoise         = 0.01;     // in, per update
+const scalar_t Drivetrain::PoseEstimator::driveEncoderNoise          = 0.1;      // in, per update (wheel slip)
+const scalar_t Drivetrain::PoseEstimator::imuNoise                   = 0.002;    // radians
+const scalar_t Drivetrain::PoseEstimator::gyroRateNoise              = 0.02;     // radians / s
+const scalar_t Drivetrain::PoseEstimator::wallDistanceNoise          = 0.5;      // in
+const scalar_t Drivetrain::PoseEstimator::wallDistanceNoiseRatio     = 0.03;     // in / in of the reading
+
+/* pose estimator wall reading rejection */
+const scalar_t Drivetrain::PoseEstimator::maxWallIncidence           = 0.5;      // radians (about 30 deg)
+const scalar_t Drivetrain::PoseEstimator::wallCornerMargin           = 6;        // in
+const scalar_t Drivetrain::PoseEstimator::innovationGate             = 3;        // standard deviations
 
 /* motion profiling constants */
-const long double Drivetrain::maxVelocity             = 60; // in / s
-const long double Drivetrain::maxAcceleration         = 40; // in / s^2
-const long double Drivetrain::drivetrainWidth   = 6.125; // in
-const long double Drivetrain::profileDT         = 0.01; // s
\ No newline at end of file
+const scalar_t Drivetrain::maxVelocity             = 60; // in / s
+const scalar_t Drivetrain::maxAcceleration         = 40; // in / s^2
+
+/* drive motor power limits */
+const scalar_t Drivetrain::driveDerateStartTemperature  = 45;       // degrees C
+const scalar_t Drivetrain::driveDerateEndTemperature    = 55;       // degrees C, the motors throttle themselves from here
+const scalar_t Drivetrain::driveMinVoltageFraction      = 0.5;
+const scalar_t Drivetrain::driveSustainedCurrent        = 1800;     // mA, 600 rpm motors are limited to 2500 mA
+const scalar_t Drivetrain::driveCurrentFilterTime       = 2;        // s
+const scalar_t Drivetrain::drivetrainWidth   = 6.125; // in
+const scalar_t Drivetrain::profileDT         = 0.01; // s
\ No newline at end of file
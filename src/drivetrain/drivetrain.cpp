@@ -2,7 +2,9 @@
 #include "pros/misc.h"
 #include "pros/rtos.h"
 #include "util/conversions.hpp"
+#include "util/fast_math.hpp"
 #include "macros.h"
+#include "robustness_trial.hpp"
 
 namespace drive {
 
@@ -18,7 +20,7 @@ bool Drivetrain::calibrated             = false;
 bool Drivetrain::autoDetermineReversed  = false;
 bool Drivetrain::driveReversed          = false;
 
-bool Drivetrain::stopped = false;
+std::atomic<bool> Drivetrain::stopped {false};
 
 int Drivetrain::linearSpeedLimit    = 12000;
 int Drivetrain::rotSpeedLimit       = 12000;
@@ -30,13 +32,22 @@ pros::Mutex Drivetrain::positionDataMutex {};
  *
  * Initialized to middle of the field
  */
-long double Drivetrain::xPos    = 72;
-long double Drivetrain::yPos    = 72;
-long double Drivetrain::heading = 90;
+scalar_t Drivetrain::xPos    = 72;
+scalar_t Drivetrain::yPos    = 72;
+scalar_t Drivetrain::heading = 90;
 
-long double Drivetrain::oldTargetX      = 72;
-long double Drivetrain::oldTargetY      = 72;
-long double Drivetrain::targetHeading   = 90;
+Drivetrain::PoseEstimator Drivetrain::poseEstimator {};
+Drivetrain::Kinematics Drivetrain::kinematics {0, 0, 0, 0};
+bool Drivetrain::relocalizationEnabled = false;
+Drivetrain::ParticleFilter Drivetrain::particleFilter {};
+bool Drivetrain::particleLocalizationEnabled = false;
+Drivetrain::PoseHistory Drivetrain::poseHistory {};
+
+Drivetrain::PowerManager Drivetrain::powerManager {};
+
+scalar_t Drivetrain::oldTargetX      = 72;
+scalar_t Drivetrain::oldTargetY      = 72;
+scalar_t Drivetrain::targetHeading   = 90;
 
 // Storage for actions to execute mid motion
 std::vector<Drivetrain::Action> Drivetrain::actionList {};
@@ -78,12 +89,12 @@ void Drivetrain::setFollowDirection(Direction direction) {
  */
 
 // Limits linear and turn speeds
-void Drivetrain::limitSpeed(long double speed) {
+void Drivetrain::limitSpeed(scalar_t speed) {
     linearSpeedLimit    = 12000 * speed / maxVelocity; // convert velocity to respective voltage
     rotSpeedLimit       = linearSpeedLimit;
 }
 
-void Drivetrain::limitLinearSpeed(long double speed) {
+void Drivetrain::limitLinearSpeed(scalar_t speed) {
     linearSpeedLimit = 12000 * speed / maxVelocity; // convert velocity to respective voltage
 }
 
@@ -120,7 +131,10 @@ positionDataMutex.give();
 }
 
 // Sets the tracked position (use to tell the Drivetrain where it is)
-void Drivetrain::setPosition(long double newX, long double newY, long double newHeading) {
+void Drivetrain::setPosition(scalar_t newX, scalar_t newY, scalar_t newHeading) {
+#ifdef ROBUSTNESS_TRIALS
+    RobustnessTrial::disturbStart(newX, newY, newHeading); // the bot is placed off of its start position
+#endif
 positionDataMutex.take();
     xPos = newX; yPos = newY;
     // wrap heading to be on the interval [0, 360)
@@ -133,29 +147,103 @@ positionDataMutex.take();
     }
     // update old targets so pure pursuit and moveForward commands function properly
     oldTargetX = newX; oldTargetY = newY; targetHeading = heading;
+    poseEstimator.reset(xPos, yPos, conversions::radians(heading));
+    particleFilter.reset(xPos, yPos, conversions::radians(heading), initialParticleSpread, initialParticleHeadingSpread);
+    kinematics = {0, 0, 0, 0};
+positionDataMutex.give();
+}
+
+// Returns the covariance of the tracked position, use to decide when the position should be corrected
+Drivetrain::PoseCovariance Drivetrain::getPoseCovariance() {
+positionDataMutex.take(20); // timeout and prevent deadlock if other task exits without freeing the mutex
+    PoseCovariance covariance = poseEstimator.getCovariance();
+positionDataMutex.give();
+    return covariance;
+}
+
+// Returns the standard deviation (inches) of the distance between the tracked and true positions
+scalar_t Drivetrain::getPositionUncertainty() {
+    PoseCovariance covariance = getPoseCovariance();
+    return sqrt(covariance.xx + covariance.yy);
+}
+
+// Returns the tracked velocities and accelerations
+Drivetrain::Kinematics Drivetrain::getKinematics() {
+positionDataMutex.take(20); // timeout and prevent deadlock if other task exits without freeing the mutex
+    Kinematics currentKinematics = kinematics;
+positionDataMutex.give();
+    return currentKinematics;
+}
+
+// Enables or disables correcting the tracked position against the field walls with the distance sensors
+void Drivetrain::setRelocalization(bool enabled) {
+positionDataMutex.take();
+    relocalizationEnabled = enabled;
 positionDataMutex.give();
 }
 
+// Enables or disables correcting the tracked position with the particle filter
+void Drivetrain::setParticleLocalization(bool enabled) {
+positionDataMutex.take();
+    if (enabled && !particleLocalizationEnabled) {
+        particleFilter.reset(
+            poseEstimator.getX(), poseEstimator.getY(), poseEstimator.getTheta(),
+            initialParticleSpread, initialParticleHeadingSpread
+        );
+    }
+    particleLocalizationEnabled = enabled;
+positionDataMutex.give();
+}
+
+// Returns the tracked position at time (microseconds, from pros::micros), interpolated between odometry updates
+Drivetrain::Point Drivetrain::getPositionAt(uint64_t time) {
+    scalar_t x, y, pastHeading;
+    if (!poseHistory.poseAt(time, x, y, pastHeading)) {
+        return {NAN, NAN, NAN};
+    }
+    return {x, y, pastHeading};
+}
+
+// Writes the stored position history as csv (time in microseconds, x, y, heading) to file
+void Drivetrain::writePositionHistory(FILE* file) {
+    poseHistory.write(file);
+}
+
+// Returns the fraction of full voltage the drive motors can currently supply (thermal and current limits)
+scalar_t Drivetrain::getAvailablePower() {
+    return powerManager.getAvailablePower();
+}
+
 // Supply power to the Drivetrain motors [-127, 127]
 // Forward and clockwise (due to controller joystick notation) are positive
 void Drivetrain::supply(int linearPow, int rotPow) {
-    frontLeftMotor.move(linearPow + rotPow);
-    topBackLeftMotor.move(linearPow + rotPow);
-    bottomBackLeftMotor.move(linearPow + rotPow);
-    frontRightMotor.move(linearPow - rotPow);
-    topBackRightMotor.move(linearPow - rotPow);
-    bottomBackRightMotor.move(linearPow - rotPow);
+    // pros::Motor::move scales [-127, 127] to [-12000, 12000] millivolts
+    supplyVoltage(linearPow * 12000 / 127, rotPow * 12000 / 127);
 }
 
 // Supply power to the Drivetrain motors [-12000, 12000]
 // Forward and clockwise (due to controller joystick notation) are positive
 void Drivetrain::supplyVoltage(int linearPow, int rotPow) {
-    frontLeftMotor.move_voltage(linearPow + rotPow);
-    topBackLeftMotor.move_voltage(linearPow + rotPow);
-    bottomBackLeftMotor.move_voltage(linearPow + rotPow);
-    frontRightMotor.move_voltage(linearPow - rotPow);
-    topBackRightMotor.move_voltage(linearPow - rotPow);
-    bottomBackRightMotor.move_voltage(linearPow - rotPow);
+
+    // the motor limits are updated by the sensor task
+    int32_t voltages[PowerManager::motorCount];
+    powerManager.distribute(
+        std::clamp(linearPow + rotPow, -12000, 12000), std::clamp(linearPow - rotPow, -12000, 12000), voltages
+    );
+
+#ifdef ROBUSTNESS_TRIALS
+    for (int32_t& voltage : voltages) {
+        voltage = RobustnessTrial::disturbVoltage(voltage); // battery sag
+    }
+#endif
+
+    frontLeftMotor.move_voltage(voltages[0]);
+    topBackLeftMotor.move_voltage(voltages[1]);
+    bottomBackLeftMotor.move_voltage(voltages[2]);
+    frontRightMotor.move_voltage(voltages[3]);
+    topBackRightMotor.move_voltage(voltages[4]);
+    bottomBackRightMotor.move_voltage(voltages[5]);
+
 }
 
 // Stops a motion early when called during that motion (pass stopMotion to addAction)
@@ -174,66 +262,162 @@ void Drivetrain::setBrakeMode(const pros::motor_brake_mode_e_t brakeMode) {
 }
 
 // Store an action to be executed during the next movement at the given error
-void Drivetrain::addAction(std::function<void()>&& action, double dist, bool duringTurn) {
-    actionList.emplace_back(std::move(action), dist, duringTurn); // construct in place
+void Drivetrain::addAction(std::function<void()>&& action, scalar_t dist, bool duringTurn) {
+    storeAction(Action {std::move(action), dist, duringTurn}); // bound to the next motion
 }
 
-// Converts encoder rotations to inches traveled
-long double Drivetrain::ticksToInches(int ticks) {
-    return trackingWheelDiameter * ticks * conversions::pi / 360;
+// Converts drive motor rotation (degrees) to inches traveled
+scalar_t Drivetrain::motorDegreesToInches(scalar_t degrees) {
+    return driveWheelDiameter * driveGearRatio * degrees * conversions::pi / 360;
 }
 
 // Carry out one step of odometry calculations, called in main task
+// Sensor readings are fused by poseEstimator, an extended Kalman filter
 void Drivetrain::trackPosition() {
 
     using conversions::radians;
     using conversions::degrees;
 
     // static state variables to calculate change in sensor values
-    static int32_t lastParallelValue        = 0;
-    static int32_t lastPerpendicularValue   = 0;
-    static double lastInertialAngle         = 0;
+    static bool firstCall                       = true;
+    static uint64_t lastTime                    = 0;
+    static uint32_t lastSnapshotSequence        = 0;
+    static uint64_t lastSnapshotTime            = 0;
+    static scalar_t lastParallelPosition        = 0;
+    static scalar_t lastPerpendicularPosition   = 0;
+    static scalar_t lastLeftPosition            = 0;
+    static scalar_t lastRightPosition           = 0;
 
     /**
-     * Main Calculations
+     * Read sensors
      */
 
-    // get encoder values
-    int32_t parallelValue       = parallelTrackingWheel.get_value();
-    int32_t perpendicularValue  = perpendicularTrackingWheel.get_value();
+    uint64_t time = pros::micros();
 
-    // Average imu values, make negative since imu uses clockwise is positive notation,
-    // but Drivetrain uses counterclockwise is positive
-    double inertialAngle        = -(imu1.get_rotation() + imu2.get_rotation()) / 2.0;
+    // get tracking wheel travel, failed reads are NAN, which poseEstimator ignores
+    scalar_t parallelPosition       = trackingWheels.getParallelDistance();
+    scalar_t perpendicularPosition  = trackingWheels.getPerpendicularDistance();
 
-    // get tracking wheel travel distances
-    long double parallelDist       = ticksToInches(parallelValue - lastParallelValue);
-    long double perpendicularDist  = ticksToInches(perpendicularValue - lastPerpendicularValue);
+    PoseEstimator::Measurements measurements {
+        parallelPosition - lastParallelPosition,
+        perpendicularPosition - lastPerpendicularPosition,
+        NAN, NAN, NAN, NAN, NAN, NAN, 0
+    };
 
     // update tracked sensor values for next call to the function
-    lastParallelValue       = parallelValue;
-    lastPerpendicularValue  = perpendicularValue;
+    if (std::isfinite(parallelPosition)) {
+        lastParallelPosition = parallelPosition;
+    }
+    if (std::isfinite(perpendicularPosition)) {
+        lastPerpendicularPosition = perpendicularPosition;
+    }
+
+    // the drive motors and IMUs are sampled by SensorHub every 10 ms, when odometry runs faster than them
+    // (Rotation sensor tracking wheels) only use them once there is a new snapshot
+    SensorHub::Snapshot snapshot = SensorHub::getSnapshot();
+    if (snapshot.sequence != lastSnapshotSequence) {
+
+        measurements.leftDist   = motorDegreesToInches(snapshot.leftDrivePosition - lastLeftPosition);
+        measurements.rightDist  = motorDegreesToInches(snapshot.rightDrivePosition - lastRightPosition);
+        measurements.driveDt    = (snapshot.time - lastSnapshotTime) / 1000000.0;
+
+        // make negative since imu uses clockwise is positive notation, but Drivetrain uses counterclockwise is positive
+        // disconnected IMUs return PROS_ERR_F (infinity), which poseEstimator ignores
+        measurements.imu1Rotation   = -radians(snapshot.imu1Rotation);
+        measurements.imu2Rotation   = -radians(snapshot.imu2Rotation);
+        measurements.imu1Rate       = -radians(snapshot.imu1Rate);
+        measurements.imu2Rate       = -radians(snapshot.imu2Rate);
+
+        if (std::isfinite(snapshot.leftDrivePosition)) {
+            lastLeftPosition = snapshot.leftDrivePosition;
+        }
+        if (std::isfinite(snapshot.rightDrivePosition)) {
+            lastRightPosition = snapshot.rightDrivePosition;
+        }
+        lastSnapshotSequence    = snapshot.sequence;
+        lastSnapshotTime        = snapshot.time;
+
+    }
+
+    /**
+     * Main Calculations
+     */
 
-    long double angle = radians(inertialAngle - lastInertialAngle);
-    lastInertialAngle = inertialAngle;
+    if (firstCall) { // start from the initial tracked position, the first readings become the reference for the IMU biases
+        firstCall = false;
+        lastTime = time;
+        poseEstimator.update(measurements, 0);
+        poseEstimator.reset(xPos, yPos, radians(heading));
+        return;
+    }
 
-    // use tracking wheel travel distances and change in heading to get local displacement
-    long double distMain    = angle == 0 ? parallelDist : 2 * (parallelDist / angle + wheelSpacingParallel) * sin(angle / 2);
-    long double distSlide   = angle == 0 ? perpendicularDist : 2 * (perpendicularDist / angle + wheelSpacingPerpendicular) * sin(angle / 2);
+    scalar_t dt = (time - lastTime) / 1000000.0;
+    lastTime = time;
+
+    poseEstimator.update(measurements, dt);
+
+    // correct against the field walls, without stopping the current motion
+    static uint64_t lastRelocalizationTime = 0;
+    if ((relocalizationEnabled || particleLocalizationEnabled)
+        && time - lastRelocalizationTime >= relocalizationPeriod * 1000
+    ) {
+        lastRelocalizationTime = time;
+        if (particleLocalizationEnabled) {
+            updateParticleFilter(snapshot);
+        } else {
+            poseEstimator.correctWallDistance(leftDistanceSensorMount, snapshot.leftDistance);
+            poseEstimator.correctWallDistance(backDistanceSensorMount, snapshot.backDistance);
+        }
+    }
 
-    // account for the fact that turning happened throughout the arc
-    long double theta = radians(heading) + angle / 2;
+    // publish the velocities, and the low pass filtered change in the velocities
+    scalar_t linearVelocity = poseEstimator.getV();
+    scalar_t angularVelocity = degrees(poseEstimator.getOmega());
+    if (dt > 0) {
+        scalar_t smoothing = dt / (accelerationFilterTime + dt);
+        kinematics.linearAcceleration +=
+            smoothing * ((linearVelocity - kinematics.linearVelocity) / dt - kinematics.linearAcceleration);
+        kinematics.angularAcceleration +=
+            smoothing * ((angularVelocity - kinematics.angularVelocity) / dt - kinematics.angularAcceleration);
+    }
+    kinematics.linearVelocity = linearVelocity;
+    kinematics.angularVelocity = angularVelocity;
 
-    // convert from polar to cartesian coordinates and update position data variables
-    xPos += distMain * cos(theta) + distSlide * sin(theta);
-    yPos += distMain * sin(theta) - distSlide * cos(theta);
-    heading += degrees(angle);
+    // update position data variables
+    xPos = poseEstimator.getX();
+    yPos = poseEstimator.getY();
+    heading = fmod(degrees(poseEstimator.getTheta()), 360);
 
     // wrap heading to be on the interval [0, 360)
-    if (heading >= 360) {
-        heading -= 360;
-    } else if (heading < 0) {
+    if (heading < 0) {
         heading += 360;
     }
+    if (heading >= 360) { // rounding of a heading just below 0
+        heading -= 360;
+    }
+
+    poseHistory.record(time, xPos, yPos, heading);
+
+}
+
+// Moves and weights the particles with the sensor readings, then corrects poseEstimator, called in trackPosition
+void Drivetrain::updateParticleFilter(const SensorHub::Snapshot& snapshot) {
+
+    particleFilter.predict(poseEstimator.getX(), poseEstimator.getY(), poseEstimator.getTheta());
+
+    particleFilter.correctWallDistance(leftDistanceSensorMount, snapshot.leftDistance);
+    particleFilter.correctWallDistance(backDistanceSensorMount, snapshot.backDistance);
+    particleFilter.correctGps(snapshot.gpsX, snapshot.gpsY, snapshot.gpsError);
+
+    particleFilter.resample();
+
+    // once the particles agree, correct odometry with their mean position
+    scalar_t spread = std::max(particleFilter.getSpread(), minParticleSpread);
+    if (spread < maxParticleSpread) {
+        poseEstimator.correctPosition(
+            particleFilter.getX(), particleFilter.getY(), spread * spread * particleVarianceInflation
+        );
+        particleFilter.setOdometryReference(poseEstimator.getX(), poseEstimator.getY(), poseEstimator.getTheta());
+    }
 
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "drivetrain.hpp"
+
+#include <cmath>
+
+using namespace drive;
+
+// converts a time in milliseconds to a number of control loops
+static uint16_t toLoops(uint32_t time) {
+    return std::min<uint32_t>(time / ExitConditions::loopPeriod, UINT16_MAX);
+}
+
+// constructs exit conditions with no checks enabled, the motion only ends if stopped
+ExitConditions::ExitConditions()
+    : hasTolerance {false}, maxError {0}, maxRotError {INFINITY}, maxVelocity {INFINITY}, maxRotVelocity {INFINITY}, settleLoops {0},
+      hasStuckDetection {false}, stuckVelocity {0}, stuckRotVelocity {0}, stuckLoops {0},
+      timeoutLoops {0}, exitAtLookAhead {false}, predicate {nullptr},
+      elapsedLoops {0}, toleranceLoop {0}, settleCount {0}, settleNoiseCount {0}, stuckCount {0}, stuckNoiseCount {0} {}
+
+// exit once error <= maxError and |rotError| <= maxRotError for the settle time
+ExitConditions ExitConditions::withTolerance(scalar_t newMaxError, scalar_t newMaxRotError) const {
+    ExitConditions exitConditions {*this};
+    exitConditions.hasTolerance = true;
+    exitConditions.maxError = newMaxError;
+    exitConditions.maxRotError = newMaxRotError;
+    return exitConditions;
+}
+
+// additionally require |velocity| <= maxVelocity and |rotVelocity| <= maxRotVelocity to be considered settled
+ExitConditions ExitConditions::withVelocityTolerance(scalar_t newMaxVelocity, scalar_t newMaxRotVelocity) const {
+    ExitConditions exitConditions {*this};
+    exitConditions.maxVelocity = newMaxVelocity;
+    exitConditions.maxRotVelocity = newMaxRotVelocity;
+    return exitConditions;
+}
+
+// time (milliseconds) the motion must remain settled to exit
+ExitConditions ExitConditions::withSettleTime(uint32_t time) const {
+    ExitConditions exitConditions {*this};
+    exitConditions.settleLoops = toLoops(time);
+    return exitConditions;
+}
+
+// exit once |velocity| <= maxVelocity and |rotVelocity| <= maxRotVelocity for time milliseconds
+ExitConditions ExitConditions::withStuckDetection(scalar_t newMaxVelocity, scalar_t newMaxRotVelocity, uint32_t time) const {
+    ExitConditions exitConditions {*this};
+    exitConditions.hasStuckDetection = true;
+    exitConditions.stuckVelocity = newMaxVelocity;
+    exitConditions.stuckRotVelocity = newMaxRotVelocity;
+    exitConditions.stuckLoops = toLoops(time);
+    return exitConditions;
+}
+
+// exit once the motion has run for time milliseconds
+ExitConditions ExitConditions::withTimeout(uint32_t time) const {
+    ExitConditions exitConditions {*this};
+    exitConditions.timeoutLoops = std::max<uint16_t>(toLoops(time), 1);
+    return exitConditions;
+}
+
+// exit once the error is within the look ahead distance
+ExitConditions ExitConditions::withLookAheadExit() const {
+    ExitConditions exitConditions {*this};
+    exitConditions.exitAtLookAhead = true;
+    return exitConditions;
+}
+
+// exit once predicate returns true
+ExitConditions ExitConditions::withCondition(Predicate newPredicate) const {
+    ExitConditions exitConditions {*this};
+    exitConditions.predicate = newPredicate;
+    return exitConditions;
+}
+
+// Resets the tracked state, called at the start of every motion
+void ExitConditions::reset() {
+    elapsedLoops = 0;
+    toleranceLoop = 0;
+    settleCount = 0;
+    settleNoiseCount = 0;
+    stuckCount = 0;
+    stuckNoiseCount = 0;
+}
+
+// Updates the tracked state and returns true if the motion should exit, call once per control loop
+bool ExitConditions::operator()(const Sample& sample) {
+
+    if (elapsedLoops < UINT16_MAX) {
+        ++elapsedLoops;
+    }
+    if (timeoutLoops != 0 && elapsedLoops >= timeoutLoops) {
+        return true; // exit if the motion timed out
+    }
+
+    if (predicate != nullptr && predicate(sample)) {
+        return true; // exit if determined by the user supplied condition
+    }
+
+    if (exitAtLookAhead && sample.error <= sample.lookAheadDistance) {
+        return true; // exit if within look ahead distance of target
+    }
+
+    if (hasTolerance) {
+
+        if (sample.firstLoop && sample.error <= maxError) {
+            return true; // exit if starting sufficiently close to target
+        }
+
+        bool withinTolerance = sample.error <= maxError && fabs(sample.rotError) <= maxRotError;
+        if (withinTolerance && toleranceLoop == 0) {
+            toleranceLoop = elapsedLoops;
+        }
+
+        if (!withinTolerance) {
+            settleCount = 0; // not near the target
+            settleNoiseCount = 0;
+        } else if (fabs(sample.velocity) <= maxVelocity && fabs(sample.rotVelocity) <= maxRotVelocity) {
+            ++settleCount; // increment time settled near target
+            settleCount += settleNoiseCount; // increment by time where velocity noise disrupted the exit conditions
+            settleNoiseCount = 0; // velocity noise is not currently significant enough to wrongfully stop exit
+            if (settleCount >= settleLoops) {
+                return true; // exit if settled near target
+            }
+        } else if (settleCount > 0) {
+            ++settleNoiseCount; // account for velocity noise
+            if (settleNoiseCount >= noiseLoops) { // if velocity is likely indeed outside acceptable thresholds, reset the counts
+                settleCount = 0;
+                settleNoiseCount = 0;
+            }
+        }
+
+    }
+
+    if (hasStuckDetection) {
+
+        if (fabs(sample.velocity) <= stuckVelocity && fabs(sample.rotVelocity) <= stuckRotVelocity) {
+            ++stuckCount; // increment time stuck
+            stuckCount += stuckNoiseCount; // increment by time where velocity noise disrupted the exit conditions
+            stuckNoiseCount = 0;
+            if (stuckCount >= stuckLoops) {
+                return true; // exit if stuck
+            }
+        } else if (stuckCount > 0) {
+            ++stuckNoiseCount; // account for velocity noise
+            if (stuckNoiseCount >= noiseLoops) {
+                stuckCount = 0;
+                stuckNoiseCount = 0;
+            }
+        }
+
+    }
+
+    return false; // not close enough to target / not stuck / did not time out
+
+}
+
+// Returns the time since the motion first came within tolerance, or if it never did, the time it has been stuck
+uint32_t ExitConditions::getSettleTime() const {
+    if (toleranceLoop != 0) {
+        return (elapsedLoops - toleranceLoop + 1) * loopPeriod;
+    }
+    return stuckCount * loopPeriod;
+}
+
+/**
+ * Factory functions matching the default exit conditions
+ */
+
+// Exit conditions for linear motions, velocities are in inches / second and degrees / second, times are in milliseconds
+Drivetrain::ExitConditions Drivetrain::linearExit(
+    scalar_t maxLinearError, scalar_t maxLinearVelocity,
+    scalar_t maxRotError, scalar_t maxRotVelocity,
+    uint32_t minTime, uint32_t maxTimeStuck
+) {
+    return ExitConditions {}
+        .withTolerance(maxLinearError, maxRotError)
+        .withVelocityTolerance(maxLinearVelocity, maxRotVelocity)
+        .withSettleTime(minTime)
+        .withStuckDetection(maxLinearVelocity, maxRotVelocity, maxTimeStuck);
+}
+
+// Exit conditions for turns, velocities are in degrees / second, times are in milliseconds
+Drivetrain::ExitConditions Drivetrain::turnExit(scalar_t maxError, scalar_t maxVelocity, uint32_t minTime, uint32_t maxTimeStuck) {
+    return ExitConditions {}
+        .withTolerance(maxError)
+        .withVelocityTolerance(maxVelocity)
+        .withSettleTime(minTime)
+        .withStuckDetection(maxVelocity, INFINITY, maxTimeStuck);
+}
+
+// Exit conditions for pure pursuit motions, velocities are in inches / second, times are in milliseconds
+Drivetrain::ExitConditions Drivetrain::purePursuitExit(scalar_t stuckVelocity, uint32_t maxTimeStuck) {
+    return ExitConditions {}
+        .withLookAheadExit()
+        .withStuckDetection(stuckVelocity, INFINITY, maxTimeStuck);
+}
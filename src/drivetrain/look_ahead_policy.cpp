@@ -0,0 +1,19 @@
+#include "drivetrain.hpp"
+
+#include <cmath>
+
+using namespace drive;
+
+// fixed look ahead distance, in inches
+LookAheadPolicy::LookAheadPolicy(scalar_t distance)
+    : minDistance {distance}, maxDistance {distance}, velocityGain {0}, curvatureGain {0} {}
+
+// adaptive look ahead distance
+LookAheadPolicy::LookAheadPolicy(scalar_t minDistance, scalar_t maxDistance, scalar_t velocityGain, scalar_t curvatureGain)
+    : minDistance {minDistance}, maxDistance {maxDistance}, velocityGain {velocityGain}, curvatureGain {curvatureGain} {}
+
+// Returns the look ahead distance given the velocity (inches per second) and the curvature (1 / inches) of the upcoming path
+scalar_t LookAheadPolicy::at(scalar_t velocity, scalar_t curvature) const {
+    scalar_t distance = (minDistance + velocityGain * fabs(velocity)) / (1 + curvatureGain * fabs(curvature));
+    return std::clamp(distance, minDistance, maxDistance);
+}
@@ -1,6 +1,8 @@
 #include "drivetrain.hpp"
+#include "auton_profiler.hpp"
 #include "util/conversions.hpp"
 #include "util/equations.hpp"
+#include "util/fast_math.hpp"
 #include "pros/rtos.h"
 
 using namespace drive;
@@ -8,7 +10,7 @@ using namespace conversions;
 using namespace equations;
 
 // constructor
-Drivetrain::Action::Action(std::function<void()>&& newAction, double atError, bool duringTurn)
+Drivetrain::Action::Action(std::function<void()>&& newAction, scalar_t atError, bool duringTurn)
     : action {std::move(newAction)}, error {atError}, duringTurn {duringTurn} {}
 
 // Follows the motion profile stored in the Path, uses feedback error correction during the motion
@@ -18,13 +20,17 @@ Drivetrain& Drivetrain::operator<<(const Path& path) {
 
     /* Initialize state data, update PID targets (ignore the profiles as they are only needed for error correction) */
     
-    stopped = false;
+#ifdef AUTON_PROFILING
+    uint32_t motionStartTime = pros::millis();
+#endif
+    startMotion(); // reset stopped, take queued actions
 
     if (autoDetermineReversed) {
         determineFollowDirection(path.target.x, path.target.y);
     }
 
-    linearPID.setNewTarget(path.lookAheadDistance, true); // follow the look ahead point at the look ahead distance
+    // follow the look ahead point at the look ahead distance (updated every loop, as it is precomputed for each step of the profile)
+    linearPID.setNewTarget(path.size() > 0 ? path[0].lookAheadDistance : 0, true);
     rotPID.setNewTarget(0, true);
 
     for (const Path::Velocities& velocitySet : path) { // go through the path
@@ -35,17 +41,19 @@ Drivetrain& Drivetrain::operator<<(const Path& path) {
 
         /* Error correction calculation */
 
+        linearPID.alterTarget(velocitySet.lookAheadDistance);
+
         // target the look ahead point
-        long double curDist = distance(velocitySet.xExtension - xPos, velocitySet.yExtension - yPos);
-        long double overallDist = distance(path.target.x - xPos, path.target.y - yPos);
+        scalar_t curDist = distance(velocitySet.xExtension - xPos, velocitySet.yExtension - yPos);
+        scalar_t overallDist = distance(path.target.x - xPos, path.target.y - yPos);
 
         int linearOutput = abs(linearPID.calcPower(curDist)); // get PIDController output
 
-        double rawAngle = atan2(velocitySet.yExtension - yPos, velocitySet.xExtension - xPos);
+        scalar_t rawAngle = fast_math::atan2(velocitySet.yExtension - yPos, velocitySet.xExtension - xPos);
 
-        long double angleToPoint = rawAngle - radians(heading);
+        scalar_t angleToPoint = rawAngle - radians(heading);
 
-        long double targetAngle = degrees(rawAngle) - (driveReversed ? 180 : 0); // face backwards if following in reverse
+        scalar_t targetAngle = degrees(rawAngle) - (driveReversed ? 180 : 0); // face backwards if following in reverse
         if (targetAngle < 0) {
             targetAngle += 360;
         }
@@ -56,16 +64,19 @@ Drivetrain& Drivetrain::operator<<(const Path& path) {
 
         // power the Drivetrain as determined by the motion profile and error correction
         supplyVoltage(
-            velocitySet.linearVoltage * (driveReversed ? -1 : 1) + linearOutput * cos(angleToPoint),
+            velocitySet.linearVoltage * (driveReversed ? -1 : 1) + linearOutput * fast_math::cos(angleToPoint),
             velocitySet.rotVoltage - rotOutput
         );
 
         // call revavent actions when close enough to the target
         executeActions(overallDist);
         if (stopped) { // end the motion if stopped early
+#ifdef AUTON_PROFILING
+            AutonProfiler::recordMotion(motionStartTime, 0, "path (%.1f, %.1f)", path.target.x, path.target.y);
+#endif
             endMotion(path.target.x, path.target.y);
             linearPID.updatePreviousSystemOutput(
-                velocitySet.linearVoltage * (driveReversed ? -1 : 1) + linearOutput * cos(angleToPoint)
+                velocitySet.linearVoltage * (driveReversed ? -1 : 1) + linearOutput * fast_math::cos(angleToPoint)
             );
             rotPID.updatePreviousSystemOutput(rotOutput - velocitySet.rotVoltage);
             return *this;
@@ -76,6 +87,9 @@ Drivetrain& Drivetrain::operator<<(const Path& path) {
 
     }
 
+#ifdef AUTON_PROFILING
+    AutonProfiler::recordMotion(motionStartTime, 0, "path (%.1f, %.1f)", path.target.x, path.target.y);
+#endif
     endMotion(path.target.x, path.target.y);
     linearPID.updatePreviousSystemOutput(0);
     rotPID.updatePreviousSystemOutput(0);
@@ -85,22 +99,56 @@ Drivetrain& Drivetrain::operator<<(const Path& path) {
 }
 
 // Uses pure pursuit to move towards the Waypoint; for optimal use utilize several pure pursuit movements in succession
+// The Waypoint is followed as a single segment PurePursuitPath starting from where the Drivetrain was last told to go
 Drivetrain& Drivetrain::operator<<(const Waypoint& p) {
+    PurePursuitPath path {{p.x, p.y}};
+    path.withLookAhead(p.lookAheadPolicy).withExitCondition(p.exitConditions);
+    followPurePursuit(path);
+    return *this; // allows operator chaining
+}
+
+// Uses pure pursuit to follow the polyline stored in the PurePursuitPath
+Drivetrain& Drivetrain::operator<<(const PurePursuitPath& path) {
+    PurePursuitPath trackedPath {path}; // copy so progress can be tracked
+    followPurePursuit(trackedPath);
+    return *this; // allows operator chaining
+}
+
+// Follows the path using pure pursuit, tracking progress along the path
+void Drivetrain::followPurePursuit(PurePursuitPath& path) {
 
-    // reset the static variables in the exit condition function
-    p.exitConditions(0, 0, true);
+    // reset the state tracked by the path's copy of the exit conditions
+    path.exitConditions.reset();
 
     /* Initialize state data, update PID targets */
 
-    stopped = false;
+#ifdef AUTON_PROFILING
+    uint32_t motionStartTime = pros::millis();
+#endif
+    startMotion(); // reset stopped, take queued actions
+
+    XYPoint endpoint = path.getEndpoint();
 
     if (autoDetermineReversed) {
-        determineFollowDirection(p.x, p.y);
+        determineFollowDirection(endpoint.x, endpoint.y);
     }
 
+    // the path starts from the previous target, which is unchanged by blended motions
+    path.begin({oldTargetX, oldTargetY});
+
     // because we target a distance of 0 from the target, the output of the linear controller will never be positive
-    linearPID.setNewTarget(0);
-    rotPID.setNewTarget(0);
+    if (blendingIn) { // continue the PID state of the motion that was blended into this one
+        linearPID.blendTarget(0);
+        rotPID.blendTarget(0);
+    } else {
+        linearPID.setNewTarget(0);
+        rotPID.setNewTarget(0);
+    }
+
+    // state used to determine the adaptive look ahead distance
+    scalar_t lookAheadDistance = path.lookAheadPolicy.maxDistance;
+
+    bool firstLoop = true;
 
     while (true) {
 
@@ -108,18 +156,29 @@ Drivetrain& Drivetrain::operator<<(const Waypoint& p) {
 
         uint32_t startTime = pros::millis();
 
+        // velocities measured by odometry
+        Kinematics currentKinematics = kinematics;
+
+        // shrink the look ahead distance for slow motions and tight upcoming curves
+        lookAheadDistance = path.lookAheadPolicy.at(
+            fabs(currentKinematics.linearVelocity), path.upcomingCurvature(lookAheadDistance)
+        );
+
         // target a point (to turn towards) look ahead distance further along on the path
-        XYPoint target = purePursuitLookAhead(p.lookAheadDistance, {p.x, p.y});
+        XYPoint target = path.lookAhead({xPos, yPos}, lookAheadDistance);
 
-        double curDist = distance(p.x - xPos, p.y - yPos); // target end of path
+        // target end of path, distance along the path is used so the bot does not slow down at intermediate points
+        scalar_t curDist = std::max(
+            distance(endpoint.x - xPos, endpoint.y - yPos), path.remainingDistance()
+        );
 
         int linearOutput = abs(linearPID.calcPower(curDist)); // get PIDController output
 
-        double rawAngle = atan2(target.y - yPos, target.x - xPos);
+        scalar_t rawAngle = fast_math::atan2(target.y - yPos, target.x - xPos);
 
-        long double angleToPoint = rawAngle - radians(heading);
+        scalar_t angleToPoint = rawAngle - radians(heading);
 
-        long double targetAngle = degrees(rawAngle) - (driveReversed ? 180 : 0); // face backwards if following in reverse
+        scalar_t targetAngle = degrees(rawAngle) - (driveReversed ? 180 : 0); // face backwards if following in reverse
         if (targetAngle < 0) {
             targetAngle += 360;
         }
@@ -131,7 +190,7 @@ Drivetrain& Drivetrain::operator<<(const Waypoint& p) {
 
         // power the Drivetrain as determined by the PIDControllers and speed limits
         supplyVoltage(
-            std::clamp(static_cast<int>(linearOutput * cos(angleToPoint)), -linearSpeedLimit, linearSpeedLimit),
+            std::clamp(static_cast<int>(linearOutput * fast_math::cos(angleToPoint)), -linearSpeedLimit, linearSpeedLimit),
             std::clamp(-rotOutput, -rotSpeedLimit, rotSpeedLimit)
         );
 
@@ -139,17 +198,25 @@ Drivetrain& Drivetrain::operator<<(const Waypoint& p) {
         executeActions(curDist);
 
         // end motion if determined by exit conditions or if stopped early
-        if (p.exitConditions(curDist, p.lookAheadDistance, false) || stopped) {
+        if (path.exitConditions({
+                curDist, rotPID.getError(),
+                currentKinematics.linearVelocity, currentKinematics.angularVelocity, lookAheadDistance, firstLoop
+            }) || stopped
+        ) {
             break;
         }
+        firstLoop = false;
 
         pros::Task::delay_until(&startTime, 10);
 
     }
 
-    endMotion(p.x, p.y);
-
-    return *this; // allows operator chaining
+#ifdef AUTON_PROFILING
+    AutonProfiler::recordMotion(
+        motionStartTime, path.exitConditions.getSettleTime(), "purePursuit (%.1f, %.1f)", endpoint.x, endpoint.y
+    );
+#endif
+    endMotion(endpoint.x, endpoint.y);
 
 }
 
@@ -161,16 +228,19 @@ Drivetrain& Drivetrain::operator>>(Point p) {
 
 // If heading is a number (is specified), will invoke turnTo after reaching the desired position
 void Drivetrain::moveTo(
-    long double x, long double y, long double heading,
+    scalar_t x, scalar_t y, scalar_t heading,
     LinearExitConditions linearExitConditions, TurnExitConditions turnExitConditions
 ) {
 
-    // reset the static variables in the exit condition function
-    linearExitConditions(0, true, true);
+    // reset the state tracked by this motion's copy of the exit conditions
+    linearExitConditions.reset();
 
     /* Initialize state data, update PID targets */
 
-    stopped = false;
+#ifdef AUTON_PROFILING
+    uint32_t motionStartTime = pros::millis();
+#endif
+    startMotion(); // reset stopped, take queued actions
 
     if (autoDetermineReversed) {
         determineFollowDirection(x, y);
@@ -179,8 +249,16 @@ void Drivetrain::moveTo(
     bool firstLoop = true; // for quick exit if starting at target
 
     // because we target a distance of 0 from the target, the output of the linear controller will never be positive
-    linearPID.setNewTarget(0);
-    rotPID.setNewTarget(targetHeading, true); // ignore the profile for maximal straight line heading correction immediately
+    if (blendingIn) { // continue the PID state of the motion that was blended into this one
+        linearPID.blendTarget(0);
+        rotPID.blendTarget(targetHeading);
+    } else {
+    positionDataMutex.take();
+        scalar_t motionSize = distance(x - xPos, y - yPos); // schedules the linear gains, heading correction uses constant gains
+    positionDataMutex.give();
+        linearPID.setNewTarget(0, false, motionSize);
+        rotPID.setNewTarget(targetHeading, true); // ignore the profile for maximal straight line heading correction immediately
+    }
 
     bool canTurn = true;
 
@@ -190,12 +268,15 @@ void Drivetrain::moveTo(
 
         uint32_t startTime = pros::millis();
 
-        double curDist = distance(x - xPos, y - yPos); // target the end point
+        // velocities measured by odometry
+        Kinematics currentKinematics = kinematics;
+
+        scalar_t curDist = distance(x - xPos, y - yPos); // target the end point
 
         int linearOutput = abs(linearPID.calcPower(curDist)); // get PIDController output
         int rotOutput;
-        double rawAngle = atan2(y - yPos, x - xPos);
-        long double angleToPoint = rawAngle - radians(Drivetrain::heading);
+        scalar_t rawAngle = fast_math::atan2(y - yPos, x - xPos);
+        scalar_t angleToPoint = rawAngle - radians(Drivetrain::heading);
 
         // if moved into or out of the min distance for turning circle around the target point
         if (canTurn == curDist < minDistForTurning) {
@@ -213,7 +294,7 @@ void Drivetrain::moveTo(
         
         if (canTurn) { // if turning is enabled
 
-            long double targetAngle = degrees(rawAngle) - (driveReversed ? 180 : 0);
+            scalar_t targetAngle = degrees(rawAngle) - (driveReversed ? 180 : 0);
             while (targetAngle < 0) {
                 targetAngle += 360;
             }
@@ -230,7 +311,7 @@ void Drivetrain::moveTo(
 
         // power the Drivetrain as determined by the PIDControllers and speed limits
         supplyVoltage(
-            std::clamp(static_cast<int>(linearOutput * cos(angleToPoint)), -linearSpeedLimit, linearSpeedLimit),
+            std::clamp(static_cast<int>(linearOutput * fast_math::cos(angleToPoint)), -linearSpeedLimit, linearSpeedLimit),
             std::clamp(-rotOutput, -rotSpeedLimit, rotSpeedLimit)
         );
 
@@ -240,7 +321,13 @@ void Drivetrain::moveTo(
         // end motion if determined by exit conditions or if stopped early
         // ternary operator is used to prevent early exit (of being at the target) during the first loop
         // cos(angleToPoint) ensures the motion can exit when turning is disabled if the bot is slightly to the side of the target
-        if (linearExitConditions(curDist * (firstLoop ? 1 : cos(angleToPoint)), firstLoop, false) || stopped) {
+        // blended motions hand off to the next motion once close enough to the target
+        if (linearExitConditions({
+                curDist * (firstLoop ? 1 : fast_math::cos(angleToPoint)), rotPID.getError(),
+                currentKinematics.linearVelocity, currentKinematics.angularVelocity, 0, firstLoop
+            }) || stopped
+            || (blendingOut && curDist <= blendDistance)
+        ) {
             break;
         }
         firstLoop = false;
@@ -249,6 +336,16 @@ void Drivetrain::moveTo(
 
     }
 
+    // a blended motion hands off without reaching its target, so actions bound closer to the target than where it
+    // handed off would otherwise never run
+    if (blendingOut && !stopped) {
+        executeRemainingActions();
+    }
+
+#ifdef AUTON_PROFILING
+    AutonProfiler::recordMotion(motionStartTime, linearExitConditions.getSettleTime(), "moveTo (%.1f, %.1f)", x, y);
+#endif
+
     if (!isnanf(heading)) { // if a heading was specified, turn to it
         turnTo(
             heading,
@@ -265,19 +362,19 @@ void Drivetrain::moveTo(
 
 // Will turn to face targetForHeading using absolute coordinates after reaching the desired position
 void Drivetrain::moveTo(
-    long double x, long double y, XYPoint targetForHeading,
+    scalar_t x, scalar_t y, XYPoint targetForHeading,
     LinearExitConditions linearExitConditions, TurnExitConditions turnExitConditions
 ) {
     moveTo(x, y, degrees(atan2(targetForHeading.y - y, targetForHeading.x - x)), linearExitConditions, turnExitConditions);
 }
 
 // Will move to the desired position
-void Drivetrain::moveTo(long double x, long double y, LinearExitConditions linearExitConditions) {
+void Drivetrain::moveTo(scalar_t x, scalar_t y, LinearExitConditions linearExitConditions) {
     moveTo(x, y, NAN, linearExitConditions);
 }
 
 // Will turn to the desired heading
-void Drivetrain::turnTo(long double heading, TurnExitConditions exitConditions) {
+void Drivetrain::turnTo(scalar_t heading, TurnExitConditions exitConditions) {
 
     // bound heading to be on the interval [0, 360)
     while (heading >= 360) {
@@ -287,18 +384,24 @@ void Drivetrain::turnTo(long double heading, TurnExitConditions exitConditions)
         heading += 360;
     }
 
-    // reset the static variables in the exit condition function
-    exitConditions(true, true);
+    // reset the state tracked by this motion's copy of the exit conditions
+    exitConditions.reset();
 
     /* Initialize state data, update PID target */
 
-    stopped = false;
+#ifdef AUTON_PROFILING
+    uint32_t motionStartTime = pros::millis();
+#endif
+    startMotion(); // reset stopped, take queued actions
 
     bool firstLoop = true; // for quick exit if starting at target
 
     targetHeading = heading;
 
-    rotPID.setNewTarget(targetHeading); // target the supplied heading
+positionDataMutex.take();
+    scalar_t motionSize = fabs(targetHeading - wrapAngle(targetHeading)); // angle of the turn, schedules the gains
+positionDataMutex.give();
+    rotPID.setNewTarget(targetHeading, false, motionSize); // target the supplied heading
 
     while (true) {
 
@@ -306,6 +409,7 @@ void Drivetrain::turnTo(long double heading, TurnExitConditions exitConditions)
         uint32_t startTime = pros::millis();
 
         int rotOutput = rotPID.calcPower(wrapAngle(targetHeading)); // get PIDController output
+        scalar_t angularVelocity = kinematics.angularVelocity; // measured by odometry
     positionDataMutex.give();
 
         // power the Drivetrain as determined by the PIDController and speed limit
@@ -315,7 +419,8 @@ void Drivetrain::turnTo(long double heading, TurnExitConditions exitConditions)
         executeActions(fabs(rotPID.getError()), true);
 
         // end motion if determined by exit conditions or if stopped early
-        if (exitConditions(firstLoop, false) || stopped) {
+        scalar_t rotError = rotPID.getError();
+        if (exitConditions({fabs(rotError), rotError, angularVelocity, angularVelocity, 0, firstLoop}) || stopped) {
             break;
         }
         firstLoop = false;
@@ -324,6 +429,9 @@ void Drivetrain::turnTo(long double heading, TurnExitConditions exitConditions)
 
     }
 
+#ifdef AUTON_PROFILING
+    AutonProfiler::recordMotion(motionStartTime, exitConditions.getSettleTime(), "turnTo %.0f", heading);
+#endif
     endMotion();
 
 }
@@ -340,20 +448,20 @@ void Drivetrain::turnTo(XYPoint target, bool absolute, TurnExitConditions exitCo
 
 // Moves forward, uses the system specified by the bool absolute to determine the desired final position
 // Does not invoke turnTo after the movement is complete
-void Drivetrain::moveForward(long double dist, bool absolute, LinearExitConditions exitConditions) {
+void Drivetrain::moveForward(scalar_t dist, bool absolute, LinearExitConditions exitConditions) {
     if (absolute) { // use old targets
-        long double curHeading = radians(targetHeading);
+        scalar_t curHeading = radians(targetHeading);
         moveTo(oldTargetX + dist * cos(curHeading), oldTargetY + dist * sin(curHeading), exitConditions);
     } else { // use current position
         Point pos = getPosition();
-        long double currHeading = radians(pos.heading);
+        scalar_t currHeading = radians(pos.heading);
         moveTo(pos.x + dist * cos(currHeading), pos.y + dist * sin(currHeading), exitConditions);
     }
 }
 
 // Updates driveReversed, call if autoDetermineReversed
-void Drivetrain::determineFollowDirection(long double xTarget, long double yTarget) {
-    double angleToPoint = degrees(atan2(yTarget - oldTargetY, xTarget - oldTargetX));
+void Drivetrain::determineFollowDirection(scalar_t xTarget, scalar_t yTarget) {
+    scalar_t angleToPoint = degrees(atan2(yTarget - oldTargetY, xTarget - oldTargetX));
     if (angleToPoint < 0) {angleToPoint += 360;}
     if (fabs(angleToPoint - wrapTargetHeading(angleToPoint)) > 90) { // if the point is behind the bot
         driveReversed = true;
@@ -363,13 +471,21 @@ void Drivetrain::determineFollowDirection(long double xTarget, long double yTarg
 }
 
 // Executes actions stored in actionList if they are eligible to be executed
-void Drivetrain::executeActions(double currError, bool inTurn) {
+void Drivetrain::executeActions(scalar_t currError, bool inTurn) {
+
+    if (runningQueuedMotion) { // report progress to the MotionHandle of the queued motion
+    motionQueueMutex.take();
+        if (currentMotion) {
+            currentMotion->error = currError;
+        }
+    motionQueueMutex.give();
+    }
 
     for (Action& action : actionList) { // check all actions
 
         if (action.duringTurn == inTurn) { // if the action corresponds to the correct type of motion (move to vs turn in place)
 
-            double& errorToExecute = action.error;
+            scalar_t& errorToExecute = action.error;
 
             // if the action has not been executed and the Drivetrain is close enough to the target
             if (errorToExecute != 0 && errorToExecute >= currError) {
@@ -383,23 +499,37 @@ void Drivetrain::executeActions(double currError, bool inTurn) {
 
 }
 
-// Sets motor power to 0, clears actionList
+// Executes the actions in actionList (not bound to turns) that have not been executed
+void Drivetrain::executeRemainingActions() {
+    for (Action& action : actionList) {
+        if (!action.duringTurn && action.error != 0) {
+            action.action();
+            action.error = 0; // mark the action as having been called
+        }
+    }
+}
+
+// Sets motor power to 0 (unless blending into the next motion), clears actionList
 void Drivetrain::endMotion() {
-    supply(0, 0);
+    if (!runningQueuedMotion || !blendIntoNextMotion()) {
+        supply(0, 0);
+    }
     actionList.clear();
 }
 
-// Sets motor power to 0, updates old target variables, clears actionList
-void Drivetrain::endMotion(long double targetX, long double targetY) {
+// Sets motor power to 0 (unless blending into the next motion), updates old target variables, clears actionList
+void Drivetrain::endMotion(scalar_t targetX, scalar_t targetY) {
     oldTargetX = targetX; oldTargetY = targetY;
-    supply(0, 0);
+    if (!runningQueuedMotion || !blendIntoNextMotion()) { // keep the motors powered until the next motion's first loop
+        supply(0, 0);
+    }
     actionList.clear();
 }
 
 // Wraps the heading based off of targetAngle to minimize the distance between the two
-long double Drivetrain::wrapAngle(long double targetAngle) {
+scalar_t Drivetrain::wrapAngle(scalar_t targetAngle) {
     
-    long double wrappedAngle;
+    scalar_t wrappedAngle;
 
     // if targetAngle is closer to 0 than 360,
     // account for shortest distance having heading being counterclockwise of targetAngle
@@ -415,9 +545,9 @@ long double Drivetrain::wrapAngle(long double targetAngle) {
 }
 
 // Wraps the targetHeading based off of targetAngle to minimize the distance between the two
-long double Drivetrain::wrapTargetHeading(long double targetAngle) {
+scalar_t Drivetrain::wrapTargetHeading(scalar_t targetAngle) {
     
-    long double wrappedAngle;
+    scalar_t wrappedAngle;
 
     // If targetAngle is closer to 0 than 360,
     // account for shortest distance having targetHeading being counterclockwise of targetAngle
@@ -431,49 +561,3 @@ long double Drivetrain::wrapTargetHeading(long double targetAngle) {
     return wrappedAngle;
 
 }
-
-// Returns 1 if positive or 0, -1 if negative
-int Drivetrain::sign(long double num) {
-    return (num >= 0 ? 1 : -1);
-}
-
-// Returns the point for the movement algorithm to target, as determined by pure pursuit
-Drivetrain::XYPoint Drivetrain::purePursuitLookAhead(
-    long double lookAheadDistance,
-    XYPoint newEndpoint
-) {
-
-    /* Get endpoint location relative to the Drivetrain (the Drivetrain is treated as the origin) */
-
-    long double x1 = oldTargetX - xPos;
-    long double y1 = oldTargetY - yPos;
-    long double x2 = newEndpoint.x - xPos;
-    long double y2 = newEndpoint.y - yPos;
-
-    // find change in coordinates between endpoints
-    long double dx = x2 - x1;
-    long double dy = y2 - y1;
-
-    long double dr = dx * dx + dy * dy;
-    if (dr == 0) {return newEndpoint;} // return early if the two endpoints are the same point
-    long double d = x1 * y2 - x2 * y1;
-    // fabs within the square root to get a real result
-    long double discriminant = sqrt(fabs(lookAheadDistance * lookAheadDistance * dr - d * d));
-
-    // find x and y coordinates (two pairs) on the line segment look ahead distance from the Drivetrain
-    long double newX1 = (d * dy + sign(dy) * dx * discriminant) / dr;
-    long double newY1 = (-d * dx + fabs(dy) * discriminant) / dr;
-    long double newX2 = (d * dy - sign(dy) * dx * discriminant) / dr;
-    long double newY2 = (-d * dx - fabs(dy) * discriminant) / dr;
-
-    // find which target point is closer
-    double dist1 = distance(newX1 - x2, newY1 - y2);
-    double dist2 = distance(newX2 - x2, newY2 - y2);
-
-    // return the closer potential target point, convert the coordinates back to field centric
-    if (dist1 <= dist2) {
-        return {newX1 + xPos, newY1 + yPos};
-    }
-    return {newX2 + xPos, newY2 + yPos};
-
-}
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "drivetrain.hpp"
+#include "util/conversions.hpp"
+#include "util/fast_math.hpp"
+
+#include <cmath>
+
+using namespace drive;
+
+// constructor, particles are at the middle of the field until reset is called
+Drivetrain::ParticleFilter::ParticleFilter() : randomState {2463534242} {
+    reset(72, 72, 0, 0, 0);
+}
+
+// Spreads the particles around the pose (theta in radians), with standard deviations positionSpread (in)
+// and headingSpread (radians), sets every weight equal, and sets the odometry reference to the pose
+void Drivetrain::ParticleFilter::reset(
+    scalar_t newX, scalar_t newY, scalar_t newTheta, scalar_t positionSpread, scalar_t headingSpread
+) {
+    for (size_t i = 0; i < particleCount; ++i) {
+        x[i]        = newX + positionSpread * gaussian();
+        y[i]        = newY + positionSpread * gaussian();
+        theta[i]    = newTheta + headingSpread * gaussian();
+        weight[i]   = 1.0f / particleCount;
+        scalar_t particleSine, particleCosine;
+        fast_math::sincos(theta[i], particleSine, particleCosine);
+        sine[i]     = particleSine;
+        cosine[i]   = particleCosine;
+    }
+    setOdometryReference(newX, newY, newTheta);
+    updateEstimate();
+}
+
+// Moves every particle by the change in the odometry pose (theta in radians) since the odometry reference,
+// then sets the odometry reference to the pose
+void Drivetrain::ParticleFilter::predict(scalar_t odometryX, scalar_t odometryY, scalar_t odometryTheta) {
+
+    // change in pose relative to the reference heading, which is applied relative to each particle's heading
+    scalar_t referenceSine, referenceCosine;
+    fast_math::sincos(referenceTheta, referenceSine, referenceCosine);
+    float forwardDist   = (odometryX - referenceX) * referenceCosine + (odometryY - referenceY) * referenceSine;
+    float leftDist      = (odometryY - referenceY) * referenceCosine - (odometryX - referenceX) * referenceSine;
+    float deltaTheta    = odometryTheta - referenceTheta;
+    setOdometryReference(odometryX, odometryY, odometryTheta);
+
+    float distNoise     = motionNoiseRatio * (fabsf(forwardDist) + fabsf(leftDist)) + motionNoiseFloor;
+    float turnNoise     = headingNoiseRatio * fabsf(deltaTheta) + headingNoiseFloor;
+    float length        = fieldLength;
+
+    for (size_t i = 0; i < particleCount; ++i) {
+
+        float particleForward   = forwardDist + distNoise * gaussian();
+        float particleLeft      = leftDist + distNoise * gaussian();
+
+        // keep the particles on the field
+        x[i] = fminf(fmaxf(x[i] + particleForward * cosine[i] - particleLeft * sine[i], 0), length);
+        y[i] = fminf(fmaxf(y[i] + particleForward * sine[i] + particleLeft * cosine[i], 0), length);
+        theta[i] += deltaTheta + turnNoise * gaussian();
+
+        scalar_t particleSine, particleCosine;
+        fast_math::sincos(theta[i], particleSine, particleCosine);
+        sine[i]     = particleSine;
+        cosine[i]   = particleCosine;
+
+    }
+    updateEstimate();
+
+}
+
+// Sets the odometry reference without moving the particles, use when the odometry pose is corrected
+void Drivetrain::ParticleFilter::setOdometryReference(scalar_t odometryX, scalar_t odometryY, scalar_t odometryTheta) {
+    referenceX      = odometryX;
+    referenceY      = odometryY;
+    referenceTheta  = odometryTheta;
+}
+
+// Weights the particles by the distance (in) to the field walls measured by the sensor at mount
+void Drivetrain::ParticleFilter::correctWallDistance(const DistanceSensorMount& mount, scalar_t reading) {
+
+    if (!std::isfinite(reading) || reading <= 0) {
+        return;
+    }
+
+    float mountSine     = std::sin(mount.angle);
+    float mountCosine   = std::cos(mount.angle);
+    float length        = fieldLength;
+    float measured      = reading;
+
+    // likelihood of the reading: normal around the wall distance, mixed with a uniform chance of hitting something else
+    float noise         = wallDistanceNoise + wallDistanceNoiseRatio * reading;
+    float normalScale   = (1 - outlierProbability) / (noise * std::sqrt(2 * conversions::pi));
+    float outlierScale  = outlierProbability / fieldLength;
+    float inverseNoise  = 1 / noise;
+
+    for (size_t i = 0; i < particleCount; ++i) {
+
+        // position of the sensor and direction it faces
+        float sensorX   = x[i] + mount.forwardOffset * cosine[i] - mount.leftOffset * sine[i];
+        float sensorY   = y[i] + mount.forwardOffset * sine[i] + mount.leftOffset * cosine[i];
+        float rayCosine = cosine[i] * mountCosine - sine[i] * mountSine;
+        float raySine   = sine[i] * mountCosine + cosine[i] * mountSine;
+
+        // distance along the ray to the closer of the walls it faces
+        float distToXWall = (rayCosine > 0 ? length - sensorX : sensorX) / fmaxf(fabsf(rayCosine), 1e-6f);
+        float distToYWall = (raySine > 0 ? length - sensorY : sensorY) / fmaxf(fabsf(raySine), 1e-6f);
+        float deviation = (measured - fminf(distToXWall, distToYWall)) * inverseNoise;
+
+        weight[i] *= normalScale * expf(-0.5f * deviation * deviation) + outlierScale;
+
+    }
+    normalizeWeights();
+    updateEstimate();
+
+}
+
+// Weights the particles by the position (in) reported by the GPS, with standard deviation error (in)
+void Drivetrain::ParticleFilter::correctGps(scalar_t gpsX, scalar_t gpsY, scalar_t error) {
+
+    if (!std::isfinite(gpsX) || !std::isfinite(gpsY) || !std::isfinite(error) || error <= 0) {
+        return;
+    }
+
+    float measuredX         = gpsX;
+    float measuredY         = gpsY;
+    float inverseVariance   = 1 / (error * error);
+    float normalScale       = 1 - outlierProbability;
+    float outlierScale      = outlierProbability;
+
+    for (size_t i = 0; i < particleCount; ++i) {
+        float offsetX = x[i] - measuredX;
+        float offsetY = y[i] - measuredY;
+        weight[i] *= normalScale * expf(-0.5f * (offsetX * offsetX + offsetY * offsetY) * inverseVariance) + outlierScale;
+    }
+    normalizeWeights();
+    updateEstimate();
+
+}
+
+// Resamples the particles if the weights are uneven (the effective number of particles is under half of the pool)
+void Drivetrain::ParticleFilter::resample() {
+
+    float sumSquared = 0;
+    for (size_t i = 0; i < particleCount; ++i) {
+        sumSquared += weight[i] * weight[i];
+    }
+    if (sumSquared * particleCount / 2 <= 1) {
+        return; // effective number of particles (1 / sumSquared) is at least half of the pool
+    }
+
+    // systematic resampling: one random offset, then evenly spaced picks along the cumulative weights
+    float step = 1.0f / particleCount;
+    float target = uniform() * step;
+    float cumulativeWeight = weight[0];
+    size_t source = 0;
+    for (size_t i = 0; i < particleCount; ++i) {
+        while (target > cumulativeWeight && source < particleCount - 1) {
+            ++source;
+            cumulativeWeight += weight[source];
+        }
+        resampledX[i]       = x[source];
+        resampledY[i]       = y[source];
+        resampledTheta[i]   = theta[source];
+        target += step;
+    }
+
+    for (size_t i = 0; i < particleCount; ++i) {
+        x[i]        = resampledX[i];
+        y[i]        = resampledY[i];
+        theta[i]    = resampledTheta[i];
+        weight[i]   = step;
+        scalar_t particleSine, particleCosine;
+        fast_math::sincos(theta[i], particleSine, particleCosine);
+        sine[i]     = particleSine;
+        cosine[i]   = particleCosine;
+    }
+    updateEstimate();
+
+}
+
+// return the weighted mean pose, theta is in radians on the interval [-pi, pi]
+scalar_t Drivetrain::ParticleFilter::getX() const {
+    return meanX;
+}
+
+scalar_t Drivetrain::ParticleFilter::getY() const {
+    return meanY;
+}
+
+scalar_t Drivetrain::ParticleFilter::getTheta() const {
+    return meanTheta;
+}
+
+// returns the standard deviation (inches) of the distance between the particles and the weighted mean position
+scalar_t Drivetrain::ParticleFilter::getSpread() const {
+    return spread;
+}
+
+// Recomputes the weighted mean pose and spread, called after the particles or weights change
+void Drivetrain::ParticleFilter::updateEstimate() {
+
+    // headings are averaged as unit vectors so headings on either side of +-pi average correctly
+    float sumX = 0, sumY = 0, sumSine = 0, sumCosine = 0;
+    for (size_t i = 0; i < particleCount; ++i) {
+        sumX        += weight[i] * x[i];
+        sumY        += weight[i] * y[i];
+        sumSine     += weight[i] * sine[i];
+        sumCosine   += weight[i] * cosine[i];
+    }
+    meanX = sumX;
+    meanY = sumY;
+    meanTheta = fast_math::atan2(sumSine, sumCosine);
+
+    float sumSquared = 0;
+    for (size_t i = 0; i < particleCount; ++i) {
+        float offsetX = x[i] - sumX;
+        float offsetY = y[i] - sumY;
+        sumSquared += weight[i] * (offsetX * offsetX + offsetY * offsetY);
+    }
+    spread = sqrt(sumSquared);
+
+}
+
+// Scales the weights to sum to 1, resets them to be equal if every weight is 0
+void Drivetrain::ParticleFilter::normalizeWeights() {
+
+    float sum = 0;
+    for (size_t i = 0; i < particleCount; ++i) {
+        sum += weight[i];
+    }
+
+    // every particle disagrees completely with the reading, the weights carry no information
+    float scale = 1 / sum;
+    if (!(sum > 0) || !std::isfinite(scale)) {
+        for (size_t i = 0; i < particleCount; ++i) {
+            weight[i] = 1.0f / particleCount;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < particleCount; ++i) {
+        weight[i] *= scale;
+    }
+
+}
+
+// returns a pseudo random number, uniform on the interval [0, 1)
+float Drivetrain::ParticleFilter::uniform() {
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (randomState >> 8) * (1.0f / 16777216); // top 24 bits, exactly representable as a float
+}
+
+// returns a pseudo random number, approximately normal with mean 0 and standard deviation 1
+float Drivetrain::ParticleFilter::gaussian() {
+    // sum of 4 uniform numbers has variance 1 / 3, scale and center it
+    return (uniform() + uniform() + uniform() + uniform() - 2) * 1.7320508f;
+}
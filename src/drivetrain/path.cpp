@@ -26,15 +26,14 @@ constexpr size_t defaultAllocCapacity   = 500;
 constexpr size_t reallocAddition        = 100;
 
 // Initialize a Path, called by motion profile generating functions, allocates internal array
-Path::Path(Point target, long double lookAheadDist)
+Path::Path(Point target)
     : target {target},
-    data {new Velocities[defaultAllocCapacity]}, length {0}, capacity {defaultAllocCapacity},
-    lookAheadDistance {lookAheadDist} {}
+    data {new Velocities[defaultAllocCapacity]}, length {0}, capacity {defaultAllocCapacity} {}
 
 // copy constructor
 Path::Path(const Path& path)
     : target {path.target},
-    length {path.length}, capacity {path.length}, lookAheadDistance {path.lookAheadDistance}
+    length {path.length}, capacity {path.length}
 {
     if (capacity > 0) {
 
@@ -52,7 +51,7 @@ Path::Path(const Path& path)
 // move constructor
 Path::Path(Path&& path)
     : target {path.target},
-    data {path.data}, length {path.length}, capacity {path.capacity}, lookAheadDistance {path.lookAheadDistance}
+    data {path.data}, length {path.length}, capacity {path.capacity}
 {
     if (capacity > 0) { // remove path access to array if array transfer occured
         path.data = nullptr;
@@ -63,9 +62,17 @@ Path::Path(Path&& path)
 
 // constructor to initialize a Path from a pre-generated array
 // This is for profiles generated by external programs
-Path::Path(Velocities* path, size_t length, Point target, long double lookAheadDist)
+// Velocities with a lookAheadDistance of 0 (not specified) are followed at lookAheadDist
+Path::Path(Velocities* path, size_t length, Point target, scalar_t lookAheadDist)
     : target {target},
-    data {path}, length {length}, capacity {length}, lookAheadDistance {lookAheadDist} {}
+    data {path}, length {length}, capacity {length}
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i].lookAheadDistance == 0) {
+            data[i].lookAheadDistance = lookAheadDist;
+        }
+    }
+}
 
 // destructor
 Path::~Path() {
@@ -75,13 +82,13 @@ Path::~Path() {
 }
 
 // Store an action to be executed during the next movement
-Path& Path::withAction(std::function<void()>&& action, double dist) {
-    actionList.emplace_back(std::move(action), dist, false); // construct in place
+Path& Path::withAction(std::function<void()>&& action, scalar_t dist) {
+    storeAction(Action {std::move(action), dist, false}); // bound to the next motion
     return *this; // allow function chaining
 }
 
 // Adds a new Velocities to the internal array, reallocates memory if needed
-void Path::add(int linearVoltage, int rotVoltage, long double xExtension, long double yExtension) {
+void Path::add(int linearVoltage, int rotVoltage, scalar_t xExtension, scalar_t yExtension, scalar_t lookAheadDistance) {
 
     if (length == capacity) { // reallocate memory if out of capacity
 
@@ -98,7 +105,7 @@ void Path::add(int linearVoltage, int rotVoltage, long double xExtension, long d
     }
 
     // update the next element to store a relavent Velocities struct
-    data[length] = {linearVoltage, rotVoltage, xExtension, yExtension};
+    data[length] = {linearVoltage, rotVoltage, xExtension, yExtension, lookAheadDistance};
     ++length;
 
 }
@@ -125,35 +132,36 @@ size_t Path::size() const {
 
 /**
  * Motion profile generation functions
- * Those without a lookAheadDist parameter are pointed to by function pointers in the drive namespace for easier calls
+ * Those without a lookAhead parameter are pointed to by function pointers in the drive namespace for easier calls
+ * and use defaultLookAheadPolicy
  */
 
 // start from current tracked position
 Path Path::generatePathTo(Point point) {
-    return generatePath(getPosition(), point, defaultLookAheadDistance);
+    return generatePath(getPosition(), point, defaultLookAheadPolicy);
 }
 
 Path Path::generatePath(Point start, Point end) {
-    return generatePath(start, end, defaultLookAheadDistance);
+    return generatePath(start, end, defaultLookAheadPolicy);
 }
 
 // start from current tracked position
-Path Path::generatePathTo(Point point, long double lookAheadDist) {
-    return generatePath(getPosition(), point, lookAheadDist);
+Path Path::generatePathTo(Point point, const LookAheadPolicy& lookAhead) {
+    return generatePath(getPosition(), point, lookAhead);
 }
 
 // use path and trajectory generation to create a motion profile
-Path Path::generatePath(Point start, Point end, long double lookAheadDist) {
+Path Path::generatePath(Point start, Point end, const LookAheadPolicy& lookAhead) {
 
     /* initialize specific path constants, */
 
-    long double totalDist = distance(start.x - end.x, start.y - end.y);
+    scalar_t totalDist = distance(start.x - end.x, start.y - end.y);
 
-    long double vx1 = totalDist * cos(radians(start.heading));
-    long double vy1 = totalDist * sin(radians(start.heading));
+    scalar_t vx1 = totalDist * cos(radians(start.heading));
+    scalar_t vy1 = totalDist * sin(radians(start.heading));
 
-    long double vx2 = totalDist * cos(radians(end.heading));
-    long double vy2 = totalDist * sin(radians(end.heading));
+    scalar_t vx2 = totalDist * cos(radians(end.heading));
+    scalar_t vy2 = totalDist * sin(radians(end.heading));
 
     /* initialize parametric path, equations used in tragectory generation based of of the parametric path */
 
@@ -171,35 +179,40 @@ Path Path::generatePath(Point start, Point end, long double lookAheadDist) {
     };
 
     // use a trapezoidal approximation to find the path length
-    long double length = (distance(eqxd.at(0), eqyd.at(0)) + distance(eqxd.at(1), eqyd.at(1))) / 2;
-    for (long double t = profileDT; t < 1; t += profileDT) {
+    scalar_t length = (distance(eqxd.at(0), eqyd.at(0)) + distance(eqxd.at(1), eqyd.at(1))) / 2;
+    for (scalar_t t = profileDT; t < 1; t += profileDT) {
         length += distance(eqxd.at(t), eqyd.at(t));
     }
     length *= profileDT;
 
     // initialize data storage before trajectory generation starts
-    Path profile {end, length};
+    Path profile {end};
 
     // initialize trajectory generation constants
-    long double distToAccel = maxVelocity * maxVelocity / (2 * maxAcceleration);
+    // the velocity and acceleration are derated with the power the drive motors can currently supply
+    // kv is not, since it converts velocity to voltage
+    scalar_t availablePower = powerManager.getAvailablePower();
+    scalar_t maxVelocity = Drivetrain::maxVelocity * availablePower;
+    scalar_t maxAcceleration = Drivetrain::maxAcceleration * availablePower;
+    scalar_t distToAccel = maxVelocity * maxVelocity / (2 * maxAcceleration);
     if (distToAccel > length / 2) {
         distToAccel = length / 2;
     }
 
     DistanceToTime toTime {eqxd, eqyd, profileDT};
 
-    long double kv = 12000 / maxVelocity;
+    scalar_t kv = 12000 / Drivetrain::maxVelocity;
 
-    long double distTraveled = 0;
+    scalar_t distTraveled = 0;
     while (distTraveled < length) { // while path has not been fully transversed
 
-        long double t = toTime.atDistance(distTraveled);
+        scalar_t t = toTime.atDistance(distTraveled);
         // get the curvature and radius if it exists
-        long double curvature = c.at(t);
-        long double r = (curvature != 0 ? fabs(1 / curvature) : 0);
+        scalar_t curvature = c.at(t);
+        scalar_t r = (curvature != 0 ? fabs(1 / curvature) : 0);
         // get the maximum forward velocity allowed by the curvature of the path
-        long double velocityByCurvature = (curvature == 0 ? maxVelocity : (r * maxVelocity) / (r + drivetrainWidth));
-        long double velocityByDistance;
+        scalar_t velocityByCurvature = (curvature == 0 ? maxVelocity : (r * maxVelocity) / (r + drivetrainWidth));
+        scalar_t velocityByDistance;
 
         if (distTraveled < distToAccel) { // if accelerating
 
@@ -220,9 +233,9 @@ Path Path::generatePath(Point start, Point end, long double lookAheadDist) {
         }
 
         // let velocity equal the smaller of the two possible maximum values
-        long double velocity = (velocityByCurvature >= velocityByDistance ? velocityByDistance : velocityByCurvature);
+        scalar_t velocity = (velocityByCurvature >= velocityByDistance ? velocityByDistance : velocityByCurvature);
 
-        long double rVelocity; long double lVelocity;
+        scalar_t rVelocity; scalar_t lVelocity;
 
         // using largerVelocity / smallerVelocity = (r + DRIVEWIDTH) / (r - DRIVEWIDTH)
         // keep in mind r is for the current position on the path
@@ -240,11 +253,14 @@ Path Path::generatePath(Point start, Point end, long double lookAheadDist) {
             lVelocity = ((r + drivetrainWidth) / r) * velocity;
         }
 
-        long double theta = atan2(eqyd.at(t), eqxd.at(t));
+        scalar_t theta = atan2(eqyd.at(t), eqxd.at(t));
+        // precompute the look ahead distance from the profiled velocity and the curvature of the path
+        scalar_t lookAheadDist = lookAhead.at(velocity, curvature);
         // add the left and right side velocities to the profile
         profile.add(
             velocity * kv, (lVelocity - rVelocity) * kv / 2,
-            eqx.at(t) + lookAheadDist * cos(theta), eqy.at(t) + lookAheadDist * sin(theta)
+            eqx.at(t) + lookAheadDist * cos(theta), eqy.at(t) + lookAheadDist * sin(theta),
+            lookAheadDist
         );
 
         // update the distance traveled
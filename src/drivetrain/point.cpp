@@ -2,32 +2,32 @@
 
 using namespace drive;
 
-Point::Point(long double x, long double y, long double heading)
+Point::Point(scalar_t x, scalar_t y, scalar_t heading)
     : x {x}, y {y}, heading {heading} {}
 
 // Store action
-Point& Point::withAction(std::function<void()>&& action, double dist, bool duringTurn) {
-    actionList.emplace_back(std::move(action), dist, duringTurn); // construct in place
+Point& Point::withAction(std::function<void()>&& action, scalar_t dist, bool duringTurn) {
+    storeAction(Action {std::move(action), dist, duringTurn}); // bound to the next motion
     return *this; // allow function chaining
 }
 
-Waypoint::Waypoint(long double x, long double y)
+Waypoint::Waypoint(scalar_t x, scalar_t y)
     : x {x}, y {y} {}
 
 // Store actions to be executed during the next movement (or pure pursuit segment)
-Waypoint& Waypoint::withAction(std::function<void()>&& action, double dist, bool duringTurn) {
-    actionList.emplace_back(std::move(action), dist, duringTurn); // construct in place
+Waypoint& Waypoint::withAction(std::function<void()>&& action, scalar_t dist, bool duringTurn) {
+    storeAction(Action {std::move(action), dist, duringTurn}); // bound to the next motion
     return *this; // allow function chaining
 }
 
-// Change the look ahead distance for the movement to this point
-Waypoint& Waypoint::withLookAhead(long double newLookAhead) {
-    lookAheadDistance = newLookAhead;
+// Change the look ahead distance for the movement to this point, pass a distance for a fixed look ahead distance
+Waypoint& Waypoint::withLookAhead(const LookAheadPolicy& newLookAhead) {
+    lookAheadPolicy = newLookAhead;
     return *this; // allow function chaining
 }
 
 // Change the exit conditions for the movement to this point
-Waypoint& Waypoint::withExitCondition(PurePursuitExitConditions newExitConditions) {
+Waypoint& Waypoint::withExitCondition(const PurePursuitExitConditions& newExitConditions) {
     exitConditions = newExitConditions;
     return *this; // allow function chaining
 }
\ No newline at end of file
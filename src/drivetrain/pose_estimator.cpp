@@ -0,0 +1,334 @@
+#include "drivetrain.hpp"
+#include "util/conversions.hpp"
+#include "util/fast_math.hpp"
+
+#include <cmath>
+
+using namespace drive;
+
+// constructor, the pose is unknown until reset is called
+Drivetrain::PoseEstimator::PoseEstimator() : state {}, covariance {}, lastImu1Rotation {0}, lastImu2Rotation {0} {}
+
+// Sets the pose (theta in radians) with no uncertainty, IMU biases are set so the last IMU readings match theta
+void Drivetrain::PoseEstimator::reset(scalar_t x, scalar_t y, scalar_t theta) {
+
+    state[xIndex]           = x;
+    state[yIndex]           = y;
+    state[thetaIndex]       = theta;
+    state[vIndex]           = 0;
+    state[vLateralIndex]    = 0;
+    state[omegaIndex]       = 0;
+    state[imu1BiasIndex]    = lastImu1Rotation - theta;
+    state[imu2BiasIndex]    = lastImu2Rotation - theta;
+
+    for (size_t i = 0; i < stateSize; ++i) {
+        for (size_t j = 0; j < stateSize; ++j) {
+            covariance[i][j] = 0;
+        }
+    }
+    // the biases were just matched to the readings, which are noisy
+    covariance[imu1BiasIndex][imu1BiasIndex] = imuNoise * imuNoise;
+    covariance[imu2BiasIndex][imu2BiasIndex] = imuNoise * imuNoise;
+
+}
+
+// Predicts the state dt seconds ahead, then corrects it with the sensor readings
+void Drivetrain::PoseEstimator::update(const Measurements& measurements, scalar_t dt) {
+
+    // the velocities are modeled as a random walk, grow their uncertainty
+    // the position also wanders a little (pushes and sliding the encoders do not see)
+    covariance[xIndex][xIndex]                  += positionDrift * positionDrift * dt;
+    covariance[yIndex][yIndex]                  += positionDrift * positionDrift * dt;
+    covariance[vIndex][vIndex]                  += accelerationNoise * accelerationNoise * dt * dt;
+    covariance[vLateralIndex][vLateralIndex]    += lateralAccelerationNoise * lateralAccelerationNoise * dt * dt;
+    covariance[omegaIndex][omegaIndex]          += angularAccelerationNoise * angularAccelerationNoise * dt * dt;
+    covariance[imu1BiasIndex][imu1BiasIndex]    += imuBiasDrift * imuBiasDrift * dt;
+    covariance[imu2BiasIndex][imu2BiasIndex]    += imuBiasDrift * imuBiasDrift * dt;
+
+    /* Velocity corrections: the encoders measure the average velocities over this update */
+
+    // tracking wheels: the parallel wheel travels the forward distance, the perpendicular wheel travels the sideways
+    // (sliding) distance, each less its offset times the change in heading
+    if (std::isfinite(measurements.parallelDist)) {
+        scalar_t h[stateSize] {};
+        h[vIndex] = dt;
+        h[omegaIndex] = -wheelSpacingParallel * dt;
+        correct(h, measurements.parallelDist, trackingWheelNoise * trackingWheelNoise);
+    }
+    if (std::isfinite(measurements.perpendicularDist)) {
+        scalar_t h[stateSize] {};
+        h[vLateralIndex] = dt;
+        h[omegaIndex] = -wheelSpacingPerpendicular * dt;
+        correct(h, measurements.perpendicularDist, trackingWheelNoise * trackingWheelNoise);
+    }
+
+    // drive sides: each side travels the forward distance, offset by half of the track width times the change in heading
+    if (std::isfinite(measurements.leftDist)) {
+        scalar_t h[stateSize] {};
+        h[vIndex] = measurements.driveDt;
+        h[omegaIndex] = -drivetrainWidth * measurements.driveDt;
+        correct(h, measurements.leftDist, driveEncoderNoise * driveEncoderNoise);
+    }
+    if (std::isfinite(measurements.rightDist)) {
+        scalar_t h[stateSize] {};
+        h[vIndex] = measurements.driveDt;
+        h[omegaIndex] = drivetrainWidth * measurements.driveDt;
+        correct(h, measurements.rightDist, driveEncoderNoise * driveEncoderNoise);
+    }
+
+    // gyros: each reports the angular velocity at the end of the update, which is close to the average for short updates
+    if (std::isfinite(measurements.imu1Rate)) {
+        scalar_t h[stateSize] {};
+        h[omegaIndex] = 1;
+        correct(h, measurements.imu1Rate, gyroRateNoise * gyroRateNoise);
+    }
+    if (std::isfinite(measurements.imu2Rate)) {
+        scalar_t h[stateSize] {};
+        h[omegaIndex] = 1;
+        correct(h, measurements.imu2Rate, gyroRateNoise * gyroRateNoise);
+    }
+
+    /* Move the pose with the corrected velocities */
+
+    predict(dt);
+
+    /* Heading corrections */
+
+    // IMUs: each reports the heading plus its bias
+    if (std::isfinite(measurements.imu1Rotation)) {
+        lastImu1Rotation = measurements.imu1Rotation;
+        scalar_t h[stateSize] {};
+        h[thetaIndex] = 1;
+        h[imu1BiasIndex] = 1;
+        correct(h, measurements.imu1Rotation, imuNoise * imuNoise);
+    }
+    if (std::isfinite(measurements.imu2Rotation)) {
+        lastImu2Rotation = measurements.imu2Rotation;
+        scalar_t h[stateSize] {};
+        h[thetaIndex] = 1;
+        h[imu2BiasIndex] = 1;
+        correct(h, measurements.imu2Rotation, imuNoise * imuNoise);
+    }
+
+}
+
+// Corrects the pose with the distance (in) to the field walls measured by the sensor at mount
+// returns false if the reading was rejected
+bool Drivetrain::PoseEstimator::correctWallDistance(const DistanceSensorMount& mount, scalar_t reading) {
+
+    if (!std::isfinite(reading) || reading <= 0) {
+        return false;
+    }
+
+    // position of the sensor on the field
+    scalar_t sine, cosine;
+    fast_math::sincos(state[thetaIndex], sine, cosine);
+    scalar_t sensorX = state[xIndex] + mount.forwardOffset * cosine - mount.leftOffset * sine;
+    scalar_t sensorY = state[yIndex] + mount.forwardOffset * sine + mount.leftOffset * cosine;
+    if (sensorX <= 0 || sensorX >= fieldLength || sensorY <= 0 || sensorY >= fieldLength) {
+        return false; // estimate is outside of the field, the ray cast is meaningless
+    }
+
+    // direction the sensor faces
+    scalar_t raySine, rayCosine;
+    fast_math::sincos(state[thetaIndex] + mount.angle, raySine, rayCosine);
+
+    // distance along the ray to the walls of constant x and constant y it faces
+    scalar_t distToXWall = INFINITY;
+    if (rayCosine > 0) {
+        distToXWall = (fieldLength - sensorX) / rayCosine;
+    } else if (rayCosine < 0) {
+        distToXWall = -sensorX / rayCosine;
+    }
+    scalar_t distToYWall = INFINITY;
+    if (raySine > 0) {
+        distToYWall = (fieldLength - sensorY) / raySine;
+    } else if (raySine < 0) {
+        distToYWall = -sensorY / raySine;
+    }
+
+    // the predicted reading is the distance to the closer wall, h is its gradient with respect to the state
+    // (the sensor position moves with theta: d(sensorX) / d(theta) = -(sensorY - y), d(sensorY) / d(theta) = sensorX - x)
+    scalar_t h[stateSize] {};
+    scalar_t predictedReading;
+    scalar_t minCosine = cos(maxWallIncidence);
+
+    if (distToXWall < distToYWall) { // faces a wall of constant x
+        scalar_t hitY = sensorY + distToXWall * raySine;
+        if (fabs(rayCosine) < minCosine || hitY < wallCornerMargin || hitY > fieldLength - wallCornerMargin) {
+            return false;
+        }
+        predictedReading = distToXWall;
+        h[xIndex] = -1 / rayCosine;
+        h[thetaIndex] = ((sensorY - state[yIndex]) + distToXWall * raySine) / rayCosine;
+    } else { // faces a wall of constant y
+        scalar_t hitX = sensorX + distToYWall * rayCosine;
+        if (fabs(raySine) < minCosine || hitX < wallCornerMargin || hitX > fieldLength - wallCornerMargin) {
+            return false;
+        }
+        predictedReading = distToYWall;
+        h[yIndex] = -1 / raySine;
+        h[thetaIndex] = -((sensorX - state[xIndex]) + distToYWall * rayCosine) / raySine;
+    }
+
+    // distance sensor error grows with distance
+    scalar_t noise = wallDistanceNoise + wallDistanceNoiseRatio * reading;
+    return correctInnovation(h, reading - predictedReading, noise * noise, innovationGate);
+
+}
+
+// Corrects the position with a measured position (in) with variance (in^2) in each direction
+void Drivetrain::PoseEstimator::correctPosition(scalar_t x, scalar_t y, scalar_t variance) {
+    if (!std::isfinite(x) || !std::isfinite(y)) {
+        return;
+    }
+    scalar_t hX[stateSize] {};
+    hX[xIndex] = 1;
+    correct(hX, x, variance);
+    scalar_t hY[stateSize] {};
+    hY[yIndex] = 1;
+    correct(hY, y, variance);
+}
+
+// return the estimated pose, theta is in radians and is not wrapped
+scalar_t Drivetrain::PoseEstimator::getX() const {
+    return state[xIndex];
+}
+
+scalar_t Drivetrain::PoseEstimator::getY() const {
+    return state[yIndex];
+}
+
+scalar_t Drivetrain::PoseEstimator::getTheta() const {
+    return state[thetaIndex];
+}
+
+// return the estimated velocities, v is in inches / second (forward is positive), omega is in radians / second
+scalar_t Drivetrain::PoseEstimator::getV() const {
+    return state[vIndex];
+}
+
+scalar_t Drivetrain::PoseEstimator::getOmega() const {
+    return state[omegaIndex];
+}
+
+// returns the covariance of the estimated position
+Drivetrain::PoseCovariance Drivetrain::PoseEstimator::getCovariance() const {
+    using conversions::degrees;
+    return {
+        covariance[xIndex][xIndex],
+        covariance[xIndex][yIndex],
+        degrees(covariance[xIndex][thetaIndex]),
+        covariance[yIndex][yIndex],
+        degrees(covariance[yIndex][thetaIndex]),
+        degrees(degrees(covariance[thetaIndex][thetaIndex]))
+    };
+}
+
+// Moves the pose dt seconds along the arc given by the velocities, and propagates the covariance
+void Drivetrain::PoseEstimator::predict(scalar_t dt) {
+
+    scalar_t v = state[vIndex];
+    scalar_t vLateral = state[vLateralIndex];
+    scalar_t omega = state[omegaIndex];
+
+    // move along the heading at the middle of the step, to account for turning throughout the step
+    scalar_t sine, cosine;
+    fast_math::sincos(state[thetaIndex] + omega * dt / 2, sine, cosine);
+
+    // forward is (cos, sin), sliding to the right is (sin, -cos)
+    state[xIndex] += v * dt * cosine + vLateral * dt * sine;
+    state[yIndex] += v * dt * sine - vLateral * dt * cosine;
+    state[thetaIndex] += omega * dt;
+
+    // Jacobian of the motion model, identity except for these entries
+    scalar_t jacobian[stateSize][stateSize] {};
+    for (size_t i = 0; i < stateSize; ++i) {
+        jacobian[i][i] = 1;
+    }
+    jacobian[xIndex][thetaIndex]        = -v * dt * sine + vLateral * dt * cosine;
+    jacobian[xIndex][vIndex]            = dt * cosine;
+    jacobian[xIndex][vLateralIndex]     = dt * sine;
+    jacobian[xIndex][omegaIndex]        = jacobian[xIndex][thetaIndex] * dt / 2;
+    jacobian[yIndex][thetaIndex]        = v * dt * cosine + vLateral * dt * sine;
+    jacobian[yIndex][vIndex]            = dt * sine;
+    jacobian[yIndex][vLateralIndex]     = -dt * cosine;
+    jacobian[yIndex][omegaIndex]        = jacobian[yIndex][thetaIndex] * dt / 2;
+    jacobian[thetaIndex][omegaIndex]    = dt;
+
+    // covariance = jacobian * covariance * jacobian^T
+    scalar_t product[stateSize][stateSize];
+    for (size_t i = 0; i < stateSize; ++i) {
+        for (size_t j = 0; j < stateSize; ++j) {
+            scalar_t sum = 0;
+            for (size_t k = 0; k < stateSize; ++k) {
+                sum += jacobian[i][k] * covariance[k][j];
+            }
+            product[i][j] = sum;
+        }
+    }
+    for (size_t i = 0; i < stateSize; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            scalar_t sum = 0;
+            for (size_t k = 0; k < stateSize; ++k) {
+                sum += product[i][k] * jacobian[j][k];
+            }
+            covariance[i][j] = sum;
+            covariance[j][i] = sum; // keep the covariance symmetric
+        }
+    }
+
+}
+
+// Corrects the state with a scalar reading modeled as the dot product of h and the state, with variance noiseVariance
+void Drivetrain::PoseEstimator::correct(const scalar_t (&h)[stateSize], scalar_t reading, scalar_t noiseVariance) {
+    scalar_t predictedReading = 0;
+    for (size_t i = 0; i < stateSize; ++i) {
+        predictedReading += h[i] * state[i];
+    }
+    correctInnovation(h, reading - predictedReading, noiseVariance);
+}
+
+// Corrects the state with the difference between a reading and its predicted value, h is the gradient of the prediction
+// returns false (without correcting) if the innovation is further than maxDeviations standard deviations from 0
+bool Drivetrain::PoseEstimator::correctInnovation(
+    const scalar_t (&h)[stateSize], scalar_t innovation, scalar_t noiseVariance, scalar_t maxDeviations
+) {
+
+    // covariance * h^T
+    scalar_t covarianceH[stateSize];
+    for (size_t i = 0; i < stateSize; ++i) {
+        scalar_t sum = 0;
+        for (size_t j = 0; j < stateSize; ++j) {
+            sum += covariance[i][j] * h[j];
+        }
+        covarianceH[i] = sum;
+    }
+
+    // variance of the innovation
+    scalar_t innovationVariance = noiseVariance;
+    for (size_t i = 0; i < stateSize; ++i) {
+        innovationVariance += h[i] * covarianceH[i];
+    }
+    if (innovationVariance <= 0) {
+        return false; // reading carries no information
+    }
+    if (innovation * innovation > maxDeviations * maxDeviations * innovationVariance) {
+        return false; // reading is an outlier
+    }
+
+    // Kalman gain, then update the state and covariance
+    scalar_t gain[stateSize];
+    for (size_t i = 0; i < stateSize; ++i) {
+        gain[i] = covarianceH[i] / innovationVariance;
+        state[i] += gain[i] * innovation;
+    }
+    for (size_t i = 0; i < stateSize; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            covariance[i][j] -= gain[i] * covarianceH[j];
+            covariance[j][i] = covariance[i][j];
+        }
+    }
+    return true;
+
+}
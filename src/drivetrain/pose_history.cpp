@@ -0,0 +1,133 @@
+#include "drivetrain.hpp"
+
+#include <cmath>
+
+using namespace drive;
+
+// constructor, the history is empty
+Drivetrain::PoseHistory::PoseHistory() : count {0} {
+    for (Entry& entry : entries) {
+        entry.index.store(UINT32_MAX, std::memory_order_relaxed);
+    }
+}
+
+// Records the pose at time (microseconds, from pros::micros), times must increase between calls
+void Drivetrain::PoseHistory::record(uint64_t time, scalar_t x, scalar_t y, scalar_t heading) {
+
+    uint32_t index = count.load(std::memory_order_relaxed);
+    Entry& entry = entries[index & (capacity - 1)];
+
+    // mark the slot as being written so readers of the old entry discard their copy
+    entry.index.store(UINT32_MAX, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.time      = time;
+    entry.x         = x;
+    entry.y         = y;
+    entry.heading   = heading;
+
+    entry.index.store(index, std::memory_order_release);
+    count.store(index + 1, std::memory_order_release);
+
+}
+
+// Returns the pose (heading in degrees on the interval [0, 360)) at time (microseconds), interpolated between
+// the recorded poses around time, returns false if time is not within the stored history
+bool Drivetrain::PoseHistory::poseAt(uint64_t time, scalar_t& x, scalar_t& y, scalar_t& heading) const {
+
+    uint32_t recorded = count.load(std::memory_order_acquire);
+    if (recorded == 0) {
+        return false;
+    }
+    uint32_t newest = recorded - 1;
+    // leave a slot of slack for the writer, which may overwrite the oldest entry during the lookup
+    uint32_t oldest = (recorded > capacity - 1 ? recorded - (capacity - 1) : 0);
+
+    uint64_t beforeTime, afterTime;
+    scalar_t beforeX, beforeY, beforeHeading, afterX, afterY, afterHeading;
+
+    if (!read(newest, afterTime, afterX, afterY, afterHeading) || time > afterTime) {
+        return false; // time is in the future
+    }
+
+    // estimate the index of the last pose at or before time from the average time between poses,
+    // then correct for timing jitter
+    if (!read(oldest, beforeTime, beforeX, beforeY, beforeHeading) || time < beforeTime) {
+        return false; // time is before the stored history
+    }
+    uint32_t index = oldest;
+    if (afterTime > beforeTime) {
+        uint64_t stepsBack = (afterTime - time) * (newest - oldest) / (afterTime - beforeTime);
+        index = newest - static_cast<uint32_t>(std::min<uint64_t>(stepsBack, newest - oldest));
+        if (!read(index, beforeTime, beforeX, beforeY, beforeHeading)) {
+            return false;
+        }
+    }
+    while (beforeTime > time) { // estimate is too new
+        if (index == oldest || !read(index - 1, beforeTime, beforeX, beforeY, beforeHeading)) {
+            return false; // time is before the stored history
+        }
+        --index;
+    }
+    while (index < newest) { // estimate may be too old
+        if (!read(index + 1, afterTime, afterX, afterY, afterHeading)) {
+            return false;
+        }
+        if (afterTime > time) {
+            break;
+        }
+        ++index;
+        beforeTime = afterTime; beforeX = afterX; beforeY = afterY; beforeHeading = afterHeading;
+    }
+
+    if (index == newest || afterTime == beforeTime) { // time is the newest pose
+        x = beforeX; y = beforeY; heading = beforeHeading;
+        return true;
+    }
+
+    // interpolate, turning the short way between the headings
+    scalar_t t = static_cast<scalar_t>(time - beforeTime) / (afterTime - beforeTime);
+    scalar_t headingChange = fmod(afterHeading - beforeHeading + 540, 360) - 180;
+    x = beforeX + t * (afterX - beforeX);
+    y = beforeY + t * (afterY - beforeY);
+    heading = fmod(beforeHeading + t * headingChange + 360, 360);
+    return true;
+
+}
+
+// Writes the stored history, oldest first, as csv (time in microseconds, x, y, heading) to file
+void Drivetrain::PoseHistory::write(FILE* file) const {
+
+    uint32_t recorded = count.load(std::memory_order_acquire);
+    uint32_t oldest = (recorded > capacity - 1 ? recorded - (capacity - 1) : 0);
+
+    fprintf(file, "time,x,y,heading\n");
+    for (uint32_t index = oldest; index < recorded; ++index) {
+        uint64_t time;
+        scalar_t x, y, heading;
+        if (read(index, time, x, y, heading)) { // skip entries overwritten while writing
+            fprintf(file, "%llu,%.3f,%.3f,%.3f\n",
+                static_cast<unsigned long long>(time), static_cast<double>(x), static_cast<double>(y),
+                static_cast<double>(heading)
+            );
+        }
+    }
+
+}
+
+// Copies the pose recorded with the index, returns false if it is no longer stored
+bool Drivetrain::PoseHistory::read(uint32_t index, uint64_t& time, scalar_t& x, scalar_t& y, scalar_t& heading) const {
+
+    const Entry& entry = entries[index & (capacity - 1)];
+
+    uint32_t indexBefore = entry.index.load(std::memory_order_acquire);
+    time    = entry.time;
+    x       = entry.x;
+    y       = entry.y;
+    heading = entry.heading;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t indexAfter = entry.index.load(std::memory_order_relaxed);
+
+    return (indexBefore == index && indexAfter == index);
+
+}
@@ -0,0 +1,75 @@
+#include "drivetrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace drive;
+
+// constructor, every motor starts unlimited
+Drivetrain::PowerManager::PowerManager() : motorLimit {}, filteredCurrent {}, lastSequence {0}, lastTime {0}, availablePower {1} {
+    for (size_t i = 0; i < motorCount; ++i) {
+        motorLimit[i] = 1;
+    }
+}
+
+// Updates the motor limits from the temperatures and current draws in snapshot, does nothing if it was already used
+void Drivetrain::PowerManager::update(const SensorHub::Snapshot& snapshot) {
+
+    if (snapshot.sequence == lastSequence) {
+        return;
+    }
+    scalar_t dt = (lastSequence == 0 ? 0 : (snapshot.time - lastTime) / 1000000.0);
+    lastSequence = snapshot.sequence;
+    lastTime = snapshot.time;
+
+    scalar_t smoothing = dt / (driveCurrentFilterTime + dt);
+    for (size_t i = 0; i < motorCount; ++i) {
+
+        // temperatures that could not be read (NAN) do not limit the motor
+        scalar_t limit = 1;
+        scalar_t temperature = snapshot.driveTemperatures[i];
+        if (temperature > driveDerateStartTemperature) {
+            scalar_t heat = (temperature - driveDerateStartTemperature)
+                / (driveDerateEndTemperature - driveDerateStartTemperature);
+            limit = 1 - heat * (1 - driveMinVoltageFraction);
+        }
+
+        scalar_t current = fabs(snapshot.driveCurrents[i]);
+        if (std::isfinite(current)) {
+            filteredCurrent[i] += smoothing * (current - filteredCurrent[i]);
+        }
+        if (filteredCurrent[i] > driveSustainedCurrent) {
+            limit = std::min(limit, driveSustainedCurrent / filteredCurrent[i]);
+        }
+
+        motorLimit[i] = std::max(limit, driveMinVoltageFraction);
+
+    }
+
+    // each side's capacity is its weakest motor's limit, the drivetrain is limited by the weaker side
+    availablePower.store(*std::min_element(motorLimit, motorLimit + motorCount), std::memory_order_relaxed);
+
+}
+
+// Sets the motor voltages (mV) from the side voltages, within the motor limits
+void Drivetrain::PowerManager::distribute(int32_t leftVoltage, int32_t rightVoltage, int32_t voltages[motorCount]) const {
+
+    // cap both sides together, so the ratio between the sides (the curvature of the motion) is kept
+    scalar_t cap = 12000 * getAvailablePower();
+    scalar_t largest = std::max(std::abs(leftVoltage), std::abs(rightVoltage));
+    scalar_t scale = (largest > cap ? cap / largest : 1);
+
+    // the side's motors share a gearbox, so they all get the same voltage (a motor given less would brake the others)
+    int32_t left = std::lround(leftVoltage * scale);
+    int32_t right = std::lround(rightVoltage * scale);
+    for (size_t i = 0; i < 3; ++i) {
+        voltages[i]     = left;
+        voltages[i + 3] = right;
+    }
+
+}
+
+// returns the fraction of full voltage both sides of the drivetrain can currently supply, 1 if no motor is limited
+scalar_t Drivetrain::PowerManager::getAvailablePower() const {
+    return availablePower.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,185 @@
+#include "drivetrain.hpp"
+#include "util/equations.hpp"
+
+#include <cmath>
+
+using namespace drive;
+using namespace equations;
+
+// constructor, points are followed in order; points beyond maxPoints are ignored
+PurePursuitPath::PurePursuitPath(std::initializer_list<XYPoint> newPoints)
+    : length {1}, segment {0}, progress {0}
+{
+    for (const XYPoint& point : newPoints) {
+        if (length > maxPoints) {
+            break;
+        }
+        points[length] = point;
+        ++length;
+    }
+    begin({0, 0}); // the real starting point is set at the start of the motion
+}
+
+// Store an action to be executed during the next movement, dist is the distance remaining along the path
+PurePursuitPath& PurePursuitPath::withAction(std::function<void()>&& action, scalar_t dist) {
+    storeAction(Action {std::move(action), dist, false}); // bound to the next motion
+    return *this; // allow function chaining
+}
+
+// Change the look ahead distance for the movement, pass a distance for a fixed look ahead distance
+PurePursuitPath& PurePursuitPath::withLookAhead(const LookAheadPolicy& newLookAhead) {
+    lookAheadPolicy = newLookAhead;
+    return *this; // allow function chaining
+}
+
+// Change the exit conditions for the movement
+PurePursuitPath& PurePursuitPath::withExitCondition(const PurePursuitExitConditions& newExitConditions) {
+    exitConditions = newExitConditions;
+    return *this; // allow function chaining
+}
+
+// Returns the final point of the path
+XYPoint PurePursuitPath::getEndpoint() const {
+    return points[length - 1];
+}
+
+// Sets the starting point of the path and resets tracked progress, called at the start of a motion
+void PurePursuitPath::begin(XYPoint start) {
+    points[0] = start;
+    distanceTo[0] = 0;
+    for (size_t i = 1; i < length; ++i) {
+        distanceTo[i] = distanceTo[i - 1] + distance(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+    }
+    segment = 0;
+    progress = 0;
+}
+
+// Updates the tracked closest point (progress never decreases) and returns the point to target
+XYPoint PurePursuitPath::lookAhead(XYPoint position, scalar_t lookAheadDist) {
+
+    if (length < 2) {
+        return points[0]; // no segments to follow
+    }
+
+    size_t lastSegment = std::min(segment + searchWindow, length - 1); // exclusive bound for the search window
+
+    /* Find the closest point on the path within the search window */
+
+    scalar_t closestDistSquared = INFINITY;
+    size_t closestSegment = segment;
+    scalar_t closestProgress = progress;
+
+    for (size_t i = segment; i < lastSegment; ++i) {
+
+        scalar_t dx = points[i + 1].x - points[i].x;
+        scalar_t dy = points[i + 1].y - points[i].y;
+        scalar_t segmentLengthSquared = dx * dx + dy * dy;
+        if (segmentLengthSquared == 0) {
+            continue; // skip repeated points
+        }
+
+        // project the position onto the segment, clamp to the segment's endpoints
+        scalar_t t = ((position.x - points[i].x) * dx + (position.y - points[i].y) * dy) / segmentLengthSquared;
+        t = std::clamp<scalar_t>(t, 0, 1);
+
+        scalar_t offsetX = points[i].x + t * dx - position.x;
+        scalar_t offsetY = points[i].y + t * dy - position.y;
+        scalar_t distSquared = offsetX * offsetX + offsetY * offsetY;
+
+        if (distSquared < closestDistSquared) {
+            closestDistSquared = distSquared;
+            closestSegment = i;
+            closestProgress = distanceTo[i] + t * (distanceTo[i + 1] - distanceTo[i]);
+        }
+
+    }
+
+    // only move forward along the path
+    if (closestProgress > progress) {
+        progress = closestProgress;
+        segment = closestSegment;
+    }
+
+    // target the end of the path once it is within the look ahead distance
+    if (distanceTo[length - 1] - progress <= lookAheadDist) {
+        return points[length - 1];
+    }
+
+    /* Find the furthest intersection of the look ahead circle with the path within the search window */
+
+    lastSegment = std::min(segment + searchWindow, length - 1);
+
+    for (size_t i = lastSegment; i-- > segment;) { // search backwards so the first intersection found is the furthest
+
+        scalar_t dx = points[i + 1].x - points[i].x;
+        scalar_t dy = points[i + 1].y - points[i].y;
+        scalar_t a = dx * dx + dy * dy;
+        if (a == 0) {
+            continue; // skip repeated points
+        }
+
+        scalar_t fx = points[i].x - position.x;
+        scalar_t fy = points[i].y - position.y;
+        scalar_t b = 2 * (fx * dx + fy * dy);
+        scalar_t c = fx * fx + fy * fy - lookAheadDist * lookAheadDist;
+        scalar_t discriminant = b * b - 4 * a * c;
+        if (discriminant < 0) {
+            continue; // circle does not reach the segment
+        }
+
+        // the larger root is the intersection further along the segment
+        scalar_t t = (-b + sqrt(discriminant)) / (2 * a);
+        scalar_t intersectionProgress = distanceTo[i] + t * (distanceTo[i + 1] - distanceTo[i]);
+        if (t >= 0 && t <= 1 && intersectionProgress >= progress) {
+            return {points[i].x + t * dx, points[i].y + t * dy};
+        }
+
+    }
+
+    // the Drivetrain is further than the look ahead distance from the path, target a point look ahead distance ahead
+    // of the closest point so the path is rejoined smoothly
+    return pointAt(progress + lookAheadDist);
+
+}
+
+// Returns the distance left to travel along the path from the tracked closest point
+scalar_t PurePursuitPath::remainingDistance() const {
+    return distanceTo[length - 1] - progress;
+}
+
+// Returns the curvature (1 / inches) of the path over the span inches following the tracked closest point
+// Uses the curvature of the circle through the closest point and the points span / 2 and span further along the path
+scalar_t PurePursuitPath::upcomingCurvature(scalar_t span) const {
+
+    XYPoint a = pointAt(progress);
+    XYPoint b = pointAt(progress + span / 2);
+    XYPoint c = pointAt(progress + span);
+
+    scalar_t ab = distance(b.x - a.x, b.y - a.y);
+    scalar_t bc = distance(c.x - b.x, c.y - b.y);
+    scalar_t ca = distance(a.x - c.x, a.y - c.y);
+    if (ab == 0 || bc == 0 || ca == 0) {
+        return 0; // points are not distinct (end of the path)
+    }
+
+    // curvature = 4 * triangle area / product of the side lengths
+    scalar_t crossProduct = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    return 2 * fabs(crossProduct) / (ab * bc * ca);
+
+}
+
+// Returns the point distAlong inches along the path, searching forward from the current segment within the search window
+XYPoint PurePursuitPath::pointAt(scalar_t distAlong) const {
+    size_t lastSegment = std::min(segment + searchWindow, length - 1);
+    for (size_t i = segment; i < lastSegment; ++i) {
+        if (distanceTo[i + 1] >= distAlong) {
+            scalar_t segmentLength = distanceTo[i + 1] - distanceTo[i];
+            scalar_t t = (segmentLength == 0 ? 1 : (distAlong - distanceTo[i]) / segmentLength);
+            return {
+                points[i].x + t * (points[i + 1].x - points[i].x),
+                points[i].y + t * (points[i + 1].y - points[i].y)
+            };
+        }
+    }
+    return points[lastSegment];
+}
@@ -0,0 +1,78 @@
+#include "drivetrain.hpp"
+#include "util/conversions.hpp"
+
+using namespace drive;
+
+/**
+ * ADITrackingWheels
+ */
+
+// constructor, ports are the top and bottom ADI ports of each encoder
+Drivetrain::ADITrackingWheels::ADITrackingWheels(
+    char parallelTopPort, char parallelBottomPort, char perpendicularTopPort, char perpendicularBottomPort, bool reversed
+)
+    : parallelEncoder {static_cast<uint8_t>(parallelTopPort), static_cast<uint8_t>(parallelBottomPort), reversed},
+    perpendicularEncoder {static_cast<uint8_t>(perpendicularTopPort), static_cast<uint8_t>(perpendicularBottomPort), reversed}
+{}
+
+void Drivetrain::ADITrackingWheels::reset() {
+    parallelEncoder.reset();
+    perpendicularEncoder.reset();
+}
+
+scalar_t Drivetrain::ADITrackingWheels::getParallelDistance() {
+    return ticksToInches(parallelEncoder.get_value());
+}
+
+scalar_t Drivetrain::ADITrackingWheels::getPerpendicularDistance() {
+    return ticksToInches(perpendicularEncoder.get_value());
+}
+
+uint32_t Drivetrain::ADITrackingWheels::getUpdatePeriod() const {
+    return 10; // the ADI is polled every 10 ms
+}
+
+// Converts encoder ticks to inches traveled
+scalar_t Drivetrain::ADITrackingWheels::ticksToInches(int32_t ticks) {
+    if (ticks == PROS_ERR) {
+        return NAN;
+    }
+    return trackingWheelDiameter * ticks * conversions::pi / 360;
+}
+
+/**
+ * RotationTrackingWheels
+ */
+
+// constructor, the direction of the sensors is set when reset
+Drivetrain::RotationTrackingWheels::RotationTrackingWheels(uint8_t parallelPort, uint8_t perpendicularPort, bool reversed)
+    : parallelSensor {parallelPort}, perpendicularSensor {perpendicularPort}, reversed {reversed} {}
+
+void Drivetrain::RotationTrackingWheels::reset() {
+    parallelSensor.set_reversed(reversed);
+    perpendicularSensor.set_reversed(reversed);
+    parallelSensor.set_data_rate(dataRate);
+    perpendicularSensor.set_data_rate(dataRate);
+    parallelSensor.reset_position();
+    perpendicularSensor.reset_position();
+}
+
+scalar_t Drivetrain::RotationTrackingWheels::getParallelDistance() {
+    return centidegreesToInches(parallelSensor.get_position());
+}
+
+scalar_t Drivetrain::RotationTrackingWheels::getPerpendicularDistance() {
+    return centidegreesToInches(perpendicularSensor.get_position());
+}
+
+uint32_t Drivetrain::RotationTrackingWheels::getUpdatePeriod() const {
+    return dataRate;
+}
+
+// Converts a Rotation sensor position (centidegrees) to inches traveled, NAN if the read failed
+scalar_t Drivetrain::RotationTrackingWheels::centidegreesToInches(int32_t centidegrees) {
+    if (centidegrees == PROS_ERR) {
+        return NAN;
+    }
+    return trackingWheelDiameter * centidegrees * conversions::pi / 36000;
+}
@@ -1,4 +1,5 @@
 #include "main.h"
+#include "autonomous.hpp"
 
 /**
  * Runs initialization code. This occurs as soon as the program is started.
@@ -13,7 +14,9 @@ void initialize() {}
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+    endAutonRun(false); // the auton task was stopped, end its run if the auton did not return
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -1,6 +1,7 @@
 #include "main.h"
 #include "drivetrain.hpp"
 #include "systems.hpp"
+#include "sensor_hub.hpp"
 #include "pros/rtos.h"
 #include "macros.h"
 
@@ -47,6 +48,7 @@ void opcontrol() {
     bool liftCommanded      = true;
 #endif
     double holdAngle        = 0;
+    uint32_t liftZeroCount  = lift.getZeroCount();
 
     /* Set default states */
 
@@ -107,17 +109,25 @@ void opcontrol() {
 
         if (usingManualControl) { // if not using macros
 
+            // the encoder was zeroed where the lift is (a stall on the hard stop or a reset), hold there in the new frame
+            uint32_t zeroCount = lift.getZeroCount();
+            if (zeroCount != liftZeroCount) {
+                liftZeroCount = zeroCount;
+                holdAngle = 0;
+            }
+
+            // full power, within the stall and temperature limit from lift supervision
             if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_R1)) { // raise lift
-                lift.motor.move(127);
+                lift.motor.move_voltage(lift.getVoltageLimit());
                 liftCommanded = true;
             } else if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) { // lower lift
-                lift.motor.move(-127);
+                lift.motor.move_voltage(-lift.getVoltageLimit());
                 liftCommanded = true;
             } else { // hold lift in place
 
                 if (liftCommanded) { // tell the lift where to hold if it was just commanded
                     liftCommanded = false;
-                    holdAngle = lift.motor.get_position();
+                    holdAngle = SensorHub::getSnapshot().liftPosition;
                     if (holdAngle < 0) { // prevent the lift from trying to hold past the physical stop
                         holdAngle = 0;
                     }
@@ -0,0 +1,242 @@
+#include "robustness_trial.hpp"
+#include "macros.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * This file contains the RobustnessTrial definitions
+ */
+
+/**
+ * Random
+ */
+
+void RobustnessTrial::Random::seed(uint64_t newSeed) {
+    state = newSeed;
+}
+
+// uniformly distributed on [0, 1)
+scalar_t RobustnessTrial::Random::uniform() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    z ^= z >> 31;
+    return (z >> 11) * 0x1.0p-53; // top 53 bits as a fraction
+}
+
+// uniformly distributed on [-range, range]
+scalar_t RobustnessTrial::Random::uniform(scalar_t range) {
+    return (2 * uniform() - 1) * range;
+}
+
+// normally distributed with mean 0 (Box-Muller transform)
+scalar_t RobustnessTrial::Random::gaussian(scalar_t standardDeviation) {
+    scalar_t u1 = 1 - uniform(); // (0, 1], as log(0) is undefined
+    scalar_t u2 = uniform();
+    return standardDeviation * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+/**
+ * RobustnessTrial
+ */
+
+const scalar_t RobustnessTrial::startPositionError  = 1;    // in
+const scalar_t RobustnessTrial::startHeadingError   = 2;    // degrees
+const scalar_t RobustnessTrial::maxImuDrift         = 0.01; // degrees per snapshot (10 ms)
+const scalar_t RobustnessTrial::maxDistanceNoise    = 0.5;  // in
+const scalar_t RobustnessTrial::minVoltageScale     = 0.85; // a sagging battery delivers about 85% of the nominal voltage
+
+std::atomic<bool> RobustnessTrial::active {false};
+uint32_t RobustnessTrial::seed {0};
+uint32_t RobustnessTrial::startTime {0};
+uint32_t RobustnessTrial::budget {0};
+RobustnessTrial::Disturbances RobustnessTrial::disturbances {0, 0, 0, 0, 0, 1};
+bool RobustnessTrial::startDisturbed {false};
+const char* RobustnessTrial::failureReason {nullptr};
+RobustnessTrial::Random RobustnessTrial::sensorRandom {};
+scalar_t RobustnessTrial::imu1Drift {0};
+scalar_t RobustnessTrial::imu2Drift {0};
+
+uint32_t RobustnessTrial::nextSeed {0};
+uint32_t RobustnessTrial::trials {0};
+uint32_t RobustnessTrial::successes {0};
+uint32_t RobustnessTrial::completionTimes[resultCapacity] {};
+uint32_t RobustnessTrial::failedSeeds[failedSeedCapacity] {};
+
+pros::Mutex RobustnessTrial::mutex {};
+
+// Starts a trial with the next seed, call before the auton runs
+void RobustnessTrial::begin(uint32_t newBudget) {
+
+mutex.take();
+
+    active = false; // stop disturbing the sensor task while its state is reset
+
+#ifdef ROBUSTNESS_TRIAL_SEED
+    seed = ROBUSTNESS_TRIAL_SEED;
+#else
+    if (trials == 0) {
+        nextSeed = pros::micros(); // distinct seeds every power on
+    }
+    seed = nextSeed++;
+#endif
+
+    Random random;
+    random.seed(seed);
+    disturbances.startX         = random.uniform(startPositionError);
+    disturbances.startY         = random.uniform(startPositionError);
+    disturbances.startHeading   = random.uniform(startHeadingError);
+    disturbances.imuDrift       = random.uniform() * maxImuDrift;
+    disturbances.distanceNoise  = random.uniform() * maxDistanceNoise;
+    disturbances.voltageScale   = minVoltageScale + random.uniform() * (1 - minVoltageScale);
+
+    // the sensor noise is a separate sequence, so it does not depend on when the sensor task samples
+    sensorRandom.seed(static_cast<uint64_t>(seed) << 32 | 1);
+    imu1Drift = imu2Drift = 0;
+    startDisturbed = false;
+    failureReason = nullptr;
+
+    startTime = pros::millis();
+    budget = newBudget;
+    active = true;
+
+mutex.give();
+
+}
+
+// Marks the current trial as failed
+void RobustnessTrial::fail(const char* reason) {
+mutex.take();
+    if (active && failureReason == nullptr) { // keep the first failure
+        failureReason = reason;
+    }
+mutex.give();
+}
+
+// Ends the current trial, recording its result
+void RobustnessTrial::end() {
+
+mutex.take(20); // timeout and prevent deadlock if the auton task was killed while holding the mutex
+
+    if (!active) {
+    mutex.give();
+        return;
+    }
+    active = false;
+
+    uint32_t runTime = pros::millis() - startTime;
+
+    if (failureReason == nullptr && runTime > budget) {
+        failureReason = "over time";
+    }
+    bool success = (failureReason == nullptr);
+
+    if (success) {
+        if (successes < resultCapacity) {
+            completionTimes[successes] = runTime;
+        }
+        ++successes;
+    } else if (trials - successes < failedSeedCapacity) {
+        failedSeeds[trials - successes] = seed;
+    }
+    ++trials;
+
+    // seed,result,time,start x,start y,start heading,imu drift,distance noise,voltage scale
+    char line[160];
+    snprintf(line, sizeof(line), "%lu,%s,%lu,%.2f,%.2f,%.2f,%.4f,%.2f,%.3f\n",
+        static_cast<unsigned long>(seed), (success ? "success" : failureReason), static_cast<unsigned long>(runTime),
+        static_cast<double>(disturbances.startX), static_cast<double>(disturbances.startY),
+        static_cast<double>(disturbances.startHeading), static_cast<double>(disturbances.imuDrift),
+        static_cast<double>(disturbances.distanceNoise), static_cast<double>(disturbances.voltageScale)
+    );
+    fputs(line, stdout);
+    if (pros::usd::is_installed()) { // keep the results of every session
+        FILE* results = fopen("/usd/robustness_trials.csv", "a");
+        if (results != nullptr) {
+            fputs(line, results);
+            fclose(results);
+        }
+    }
+
+mutex.give();
+
+}
+
+// Returns true while a trial is running
+bool RobustnessTrial::isActive() {
+    return active;
+}
+
+// Offsets a start position by the start position error, only the first call of a trial is offset
+void RobustnessTrial::disturbStart(scalar_t& x, scalar_t& y, scalar_t& heading) {
+mutex.take();
+    if (active && !startDisturbed) {
+        x += disturbances.startX;
+        y += disturbances.startY;
+        heading += disturbances.startHeading;
+        startDisturbed = true;
+    }
+mutex.give();
+}
+
+// Adds sensor noise to snapshot, called in the sensor task for each snapshot
+void RobustnessTrial::disturbSnapshot(SensorHub::Snapshot& snapshot) {
+
+    if (!active) {
+        return;
+    }
+
+    // IMU error accumulates, so the rotations drift rather than being noisy about the true rotation
+    imu1Drift += sensorRandom.gaussian(disturbances.imuDrift);
+    imu2Drift += sensorRandom.gaussian(disturbances.imuDrift);
+    snapshot.imu1Rotation += imu1Drift;
+    snapshot.imu2Rotation += imu2Drift;
+
+    // NAN readings (nothing detected) stay NAN
+    snapshot.leftDistance += sensorRandom.gaussian(disturbances.distanceNoise);
+    snapshot.backDistance += sensorRandom.gaussian(disturbances.distanceNoise);
+
+}
+
+// Returns the voltage a drive motor receives when voltage is commanded
+int32_t RobustnessTrial::disturbVoltage(int32_t voltage) {
+    if (!active) {
+        return voltage;
+    }
+    return voltage * disturbances.voltageScale;
+}
+
+// Writes the number of trials, success rate, completion time distribution, and failed seeds since power on to file
+void RobustnessTrial::writeSummary(FILE* file) {
+
+mutex.take(20);
+
+    fprintf(file, "trials: %lu, succeeded: %lu (%.1f%%)\n",
+        static_cast<unsigned long>(trials), static_cast<unsigned long>(successes),
+        (trials == 0 ? 0.0 : 100.0 * successes / trials)
+    );
+
+    size_t timeCount = std::min<size_t>(successes, resultCapacity);
+    if (timeCount > 0) {
+        uint32_t times[resultCapacity];
+        std::copy(completionTimes, completionTimes + timeCount, times);
+        std::sort(times, times + timeCount);
+        fprintf(file, "completion time (ms): min %lu, median %lu, 90th percentile %lu, max %lu\n",
+            static_cast<unsigned long>(times[0]), static_cast<unsigned long>(times[timeCount / 2]),
+            static_cast<unsigned long>(times[timeCount * 9 / 10]), static_cast<unsigned long>(times[timeCount - 1])
+        );
+    }
+
+    size_t failedCount = std::min<size_t>(trials - successes, failedSeedCapacity);
+    if (failedCount > 0) {
+        fprintf(file, "failed seeds (define ROBUSTNESS_TRIAL_SEED to repeat the disturbances):");
+        for (size_t i = 0; i < failedCount; ++i) {
+            fprintf(file, " %lu", static_cast<unsigned long>(failedSeeds[i]));
+        }
+        fprintf(file, "\n");
+    }
+
+mutex.give();
+
+}
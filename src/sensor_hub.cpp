@@ -0,0 +1,113 @@
+#include "sensor_hub.hpp"
+#include "drivetrain.hpp"
+#include "systems.hpp"
+#include "macros.h"
+#include "robustness_trial.hpp"
+
+/**
+ * This file contains the SensorHub definitions
+ */
+
+// both buffers start as the empty snapshot (sequence 0)
+SensorHub::Buffer SensorHub::buffers[2] {};
+std::atomic<uint32_t> SensorHub::published {0};
+
+// returns the latest snapshot
+SensorHub::Snapshot SensorHub::getSnapshot() {
+
+    while (true) {
+
+        uint32_t sequence = published.load(std::memory_order_acquire);
+        const Buffer& buffer = buffers[sequence & 1];
+
+        uint32_t sequenceBefore = buffer.sequence.load(std::memory_order_acquire);
+        Snapshot snapshot = buffer.snapshot;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t sequenceAfter = buffer.sequence.load(std::memory_order_relaxed);
+
+        if (sequenceBefore == sequence && sequenceAfter == sequence) {
+            return snapshot;
+        }
+        // the sensor task published twice while the snapshot was copied, copy the new latest snapshot
+
+    }
+
+}
+
+// reads every sampled device and publishes the readings as the latest snapshot
+void SensorHub::sample() {
+
+    uint32_t sequence = published.load(std::memory_order_relaxed) + 1;
+    Buffer& buffer = buffers[sequence & 1];
+
+    // mark the buffer as being written so readers of the old snapshot discard their copy
+    buffer.sequence.store(UINT32_MAX, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Snapshot& snapshot = buffer.snapshot;
+    snapshot.time       = pros::micros();
+    snapshot.sequence   = sequence;
+
+    snapshot.leftDrivePosition  = (Drivetrain::frontLeftMotor.get_position() + Drivetrain::topBackLeftMotor.get_position()
+        + Drivetrain::bottomBackLeftMotor.get_position()) / 3;
+    snapshot.rightDrivePosition = (Drivetrain::frontRightMotor.get_position() + Drivetrain::topBackRightMotor.get_position()
+        + Drivetrain::bottomBackRightMotor.get_position()) / 3;
+
+    const pros::Motor* driveMotors[6] {
+        &Drivetrain::frontLeftMotor, &Drivetrain::topBackLeftMotor, &Drivetrain::bottomBackLeftMotor,
+        &Drivetrain::frontRightMotor, &Drivetrain::topBackRightMotor, &Drivetrain::bottomBackRightMotor
+    };
+    for (size_t i = 0; i < 6; ++i) {
+        int32_t current = driveMotors[i]->get_current_draw();
+        snapshot.driveTemperatures[i]   = driveMotors[i]->get_temperature();
+        snapshot.driveCurrents[i]       = (current == PROS_ERR ? NAN : current);
+    }
+
+    snapshot.imu1Rotation   = Drivetrain::imu1.get_rotation();
+    snapshot.imu2Rotation   = Drivetrain::imu2.get_rotation();
+    snapshot.imu1Rate       = Drivetrain::imu1.get_gyro_rate().z;
+    snapshot.imu2Rate       = Drivetrain::imu2.get_gyro_rate().z;
+
+    snapshot.leftDistance   = readDistanceSensor(Drivetrain::leftDistanceSensor);
+    snapshot.backDistance   = readDistanceSensor(Drivetrain::backDistanceSensor);
+
+    // the GPS reports meters from the center of the field along its own axes, rotate them onto the field axes
+    // and move the origin to the corner, disconnected GPSs return PROS_ERR_F (infinity)
+    pros::c::gps_status_s_t gpsStatus = Drivetrain::gps.get_status();
+    scalar_t gpsSine = sin(Drivetrain::gpsFieldRotation);
+    scalar_t gpsCosine = cos(Drivetrain::gpsFieldRotation);
+    snapshot.gpsX       = Drivetrain::fieldLength / 2 + (gpsStatus.x * gpsCosine - gpsStatus.y * gpsSine) * 39.37;
+    snapshot.gpsY       = Drivetrain::fieldLength / 2 + (gpsStatus.x * gpsSine + gpsStatus.y * gpsCosine) * 39.37;
+    snapshot.gpsError   = Drivetrain::gps.get_error() * 39.37;
+
+    // failed reads are PROS_ERR (integer readings) or PROS_ERR_F
+    const pros::Motor& liftMotor = motor_control::Lift::motor;
+    int32_t liftCurrent = liftMotor.get_current_draw();
+    int32_t liftVoltage = liftMotor.get_voltage();
+    snapshot.liftPosition       = liftMotor.get_position();
+    snapshot.liftVelocity       = liftMotor.get_actual_velocity() * 6; // rpm to degrees/s
+    snapshot.liftCurrent        = (liftCurrent == PROS_ERR ? NAN : liftCurrent);
+    snapshot.liftVoltage        = (liftVoltage == PROS_ERR ? NAN : liftVoltage);
+    snapshot.liftTemperature    = liftMotor.get_temperature();
+
+#ifdef ROBUSTNESS_TRIALS
+    RobustnessTrial::disturbSnapshot(snapshot);
+#endif
+
+    buffer.sequence.store(sequence, std::memory_order_release);
+    published.store(sequence, std::memory_order_release);
+
+    // the drive motor limits are only updated here, so a single task writes them
+    Drivetrain::powerManager.update(snapshot);
+
+}
+
+// Returns the reading (in) of sensor, NAN if the reading is unusable
+scalar_t SensorHub::readDistanceSensor(pros::Distance& sensor) {
+    int32_t reading = sensor.get(); // mm
+    // disconnected sensors return PROS_ERR, 9999 is returned when nothing is detected, readings past 2 m are unreliable
+    if (reading == PROS_ERR || reading <= 0 || reading > 2000) {
+        return NAN;
+    }
+    return reading / 25.4;
+}
@@ -10,7 +10,7 @@ namespace motor_control {
     const int Intake::intakeSpeed = 127;
 
     // Angles of the lift motor from lowest to highest preset height
-    const long double Lift::angles[5] = {
+    const scalar_t Lift::angles[5] = {
         
         0,  // fully lowered
         200, // slightly raised to intake rings
@@ -20,4 +20,41 @@ namespace motor_control {
     
     };
 
+    // lift motion profile, max velocity (degrees/s) and acceleration (degrees/s^2) of the motor
+    // 540 degrees/s is 90% of the free speed of a 100 rpm motor, leaving voltage headroom for feedback
+    TrapezoidalProfile Lift::profile {540, 2400};
+
+    // PID for tracking the lift profile, error is in motor degrees
+    PIDController Lift::pid {0.03, 0.0015, 0.01, 1.5, 0, 12, 0, 0.02};
+
+    // lift feedforward constants (volts)
+    const scalar_t Lift::kS     = 0.4;      // V
+    const scalar_t Lift::kV     = 0.02;     // V / (degree / s), 12 V / 600 degrees/s free speed
+    const scalar_t Lift::kA     = 0.0008;   // V / (degree / s^2)
+    const scalar_t Lift::kG     = 1.2;      // V with the arm horizontal and the claw empty
+    const scalar_t Lift::kLoad  = 1.6;      // V added with the arm horizontal and a goal in the claw
+
+    // lift geometry, used to scale the gravity feedforward
+    const scalar_t Lift::horizontalAngle    = 420;          // motor degrees
+    const scalar_t Lift::armRatio           = 1.0 / 7;      // arm degrees per motor degree (7:1 external gearing)
+
+    // lift update timing, the state machine also runs whenever the requested state changes
+    const uint32_t Lift::controlPeriod      = 10;   // ms, while moving
+    const uint32_t Lift::supervisionPeriod  = 100;  // ms, while holding a preset or idle (manual control, unpowered)
+    const int32_t Lift::holdVelocity        = 100;  // rpm
+    const scalar_t Lift::settledError       = 8;    // motor degrees
+    const int32_t Lift::voltageDeadband     = 50;   // mV
+
+    // lift supervision, a stall is high current draw without moving for stallTime
+    const scalar_t Lift::stallVelocity          = 5;        // degrees/s
+    const scalar_t Lift::stallCurrent           = 1500;     // mA, 100 rpm motors are limited to 2500 mA
+    const uint32_t Lift::stallTime              = 150;      // ms
+    const scalar_t Lift::zeroWindow             = 60;       // motor degrees
+    const int32_t Lift::stallVoltageLimit       = 3000;     // mV
+
+    // lift thermal derating, motors throttle themselves from 55 degrees C
+    const scalar_t Lift::derateStartTemperature = 45;       // degrees C
+    const scalar_t Lift::derateEndTemperature   = 55;       // degrees C
+    const scalar_t Lift::minVoltageFraction     = 0.5;
+
 } // namespace motor_control
\ No newline at end of file
@@ -1,6 +1,15 @@
 #include "systems/lift.hpp"
 #include "pros/motors.h"
 #include "pros/rtos.h"
+#include "sensor_hub.hpp"
+#include "util/conversions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// task that runs the lift state machine, defined in src/util/task_manager.cpp
+extern pros::Task systemsTask;
 
 namespace motor_control {
 
@@ -18,11 +27,30 @@ namespace motor_control {
 
     bool Lift::clamping            = true;
 
+    size_t Lift::targetIndex           = Lift::noTarget;
+    uint64_t Lift::profileStartTime    = 0;
+    int32_t Lift::lastVoltage          = Lift::noVoltage;
+    uint64_t Lift::zeroTime            = 0;
+    uint32_t Lift::zeroCount           = 0;
+    bool Lift::settled                 = false;
+
+    uint64_t Lift::stallStartTime      = 0;
+    bool Lift::stalled                 = false;
+    int32_t Lift::voltageLimit         = 12000;
+    bool Lift::derating                = false;
+
+    Lift::LogEntry Lift::eventLog[Lift::logCapacity] {};
+    size_t Lift::loggedEvents          = 0;
+
     // zero the lift integrated motor encoder and set it to use degrees for angular measurments
     void Lift::init() {
     mutex.take();
         motor.set_encoder_units(pros::E_MOTOR_ENCODER_DEGREES);
         motor.tare_position();
+        zeroTime = pros::micros();
+        ++zeroCount;
+        targetIndex = noTarget;
+        lastVoltage = noVoltage;
     mutex.give();
     }
 
@@ -32,6 +60,7 @@ namespace motor_control {
         liftIsUp = true;
         subposition = Subposition::neutral;
     mutex.give();
+        notifyStateChange();
     }
 
     // sets the lift to lower, the subposition to neutral
@@ -40,6 +69,7 @@ namespace motor_control {
         liftIsUp = false;
         subposition = Subposition::neutral;
     mutex.give();
+        notifyStateChange();
     }
 
     // sets the lift to lower if it is raised, otherwise sets it to raise, sets the subposition to neutral
@@ -48,6 +78,7 @@ namespace motor_control {
         liftIsUp = !liftIsUp;
         subposition = Subposition::neutral;
     mutex.give();
+        notifyStateChange();
     }
 
     // returns true if the lift is currently raised, false otherwise
@@ -59,11 +90,21 @@ namespace motor_control {
         return liftState;
     }
 
+    // returns true if the lift has finished moving to the preset requested by the current states
+    bool Lift::isSettled() {
+    mutex.take();
+        // the requested preset may have changed since powerLift last ran
+        bool liftSettled = !usingManualControl && targetIndex == requestedIndex() && settled;
+    mutex.give();
+        return liftSettled;
+    }
+
     // sets the current subposition of the lift to the one specified
     void Lift::setSubposition(Subposition subpos) {
     mutex.take();
         subposition = subpos;
     mutex.give();
+        notifyStateChange();
     }
 
     // if the subposition is high, sets it to low, otherwise (even if subposition is neutral) sets the subposition to high
@@ -75,6 +116,7 @@ namespace motor_control {
             subposition = Subposition::high;
         }
     mutex.give();
+        notifyStateChange();
     }
 
     // sets the manual control status to the specified state
@@ -82,27 +124,34 @@ namespace motor_control {
     void Lift::setManualControl(bool manualControl) {
     mutex.take();
         usingManualControl = manualControl;
+        // the lift may have been moved manually, plan the next profile from where it is and resend the voltage
+        targetIndex = noTarget;
+        lastVoltage = noVoltage;
         liftIsUp = false;
         subposition = Subposition::neutral;
     mutex.give();
+        notifyStateChange();
     }
 
     // closes the claw
     void Lift::clamp() {
         claw.set_value(false);
         clamping = true;
+        notifyStateChange(); // the load feedforward changed
     }
 
     // opens the claw
     void Lift::release() {
         claw.set_value(true);
         clamping = false;
+        notifyStateChange(); // the load feedforward changed
     }
 
     // if the claw is open, closes it, otherwise opens it
     void Lift::toggleClamp() {
         claw.set_value(clamping);
         clamping = !clamping;
+        notifyStateChange(); // the load feedforward changed
     }
 
     // returns true if the claw is currently closed, false otherwise
@@ -114,30 +163,211 @@ namespace motor_control {
     void Lift::reset() {
     mutex.take();
         motor.tare_position();
+        zeroTime = pros::micros();
+        ++zeroCount;
+        targetIndex = noTarget;
+        lastVoltage = noVoltage;
+    mutex.give();
+        notifyStateChange();
+    }
+
+    // returns the max voltage (mV) the lift may be supplied, from the stall and temperature state
+    int32_t Lift::getVoltageLimit() {
+    mutex.take();
+        int32_t limit = voltageLimit;
+    mutex.give();
+        return limit;
+    }
+
+    // returns the number of times the encoder has been zeroed (by init, reset, or a stall on the bottom hard stop)
+    uint32_t Lift::getZeroCount() {
+    mutex.take();
+        uint32_t count = zeroCount;
     mutex.give();
+        return count;
     }
 
     // This function runs the state machine that moves the lift to the appropriate position given the requested states
     // if manual control is disabled
-    // This function uses the motor's built in PID controller to reach the desired position
-    void Lift::powerLift() {
+    // When the requested preset changes, a motion profile is planned from the current setpoint to the new preset,
+    // then the profile is tracked with PID and feedforward, once settled the motor's position controller holds the preset
+    // returns the time (milliseconds) until powerLift needs to run again if no state changes are made
+    uint32_t Lift::powerLift() {
+        uint32_t period = controlPeriod;
     mutex.take(20); // timeout and prevent deadlock if other task exits without freeing the mutex
 
-        if (!usingManualControl) { // if other tasks are not controlling the lift
+        SensorHub::Snapshot snapshot = SensorHub::getSnapshot();
+        if (snapshot.time > zeroTime && std::isfinite(snapshot.liftPosition)) {
+            supervise(snapshot); // may zero the encoder, which makes the snapshot stale
+        }
+
+        if (usingManualControl) {
+            // supervise the motor at the control rate while the driver powers it, the lift is idle while unpowered
+            if (snapshot.liftVoltage == 0) {
+                period = supervisionPeriod;
+            }
+        } else if (snapshot.time <= zeroTime || !std::isfinite(snapshot.liftPosition)) {
+            // the latest snapshot was taken before the encoder was zeroed (or the motor could not be read), wait for the next
+        } else { // if other tasks are not controlling the lift
+
+            size_t pos = requestedIndex();
+
+            uint64_t time = pros::micros();
+            scalar_t angle = snapshot.liftPosition;
+
+            // plan a new profile when the requested angle changes, starting from the current setpoint so the
+            // planned motion stays continuous, or from the measured angle if there is no profile to continue
+            if (pos != targetIndex) {
+                if (targetIndex == noTarget) {
+                    profile.plan(angle, angles[pos]);
+                } else {
+                    TrapezoidalProfile::State current = profile.at((time - profileStartTime) / 1e6);
+                    profile.plan(current.position, angles[pos], current.velocity);
+                }
+                pid.setNewTarget(profile.at(0).position, true);
+                targetIndex = pos;
+                profileStartTime = time;
+                settled = false;
+                if (stalled) { // try the new preset at full voltage
+                    stalled = false;
+                    stallStartTime = 0;
+                    logEvent(Event::stallCleared, snapshot);
+                }
+            }
+
+            bool holding = (settled && voltageLimit == 12000);
+            if (!holding) { // track the profile to the preset
+
+                TrapezoidalProfile::State setpoint = profile.at((time - profileStartTime) / 1e6);
+
+                // gravity torque is greatest when the arm is horizontal
+                scalar_t gravity = (kG + (clamping ? kLoad : 0))
+                    * cos((setpoint.position - horizontalAngle) * armRatio * conversions::pi / 180);
+                scalar_t friction = (setpoint.velocity > 0 ? kS : (setpoint.velocity < 0 ? -kS : 0));
+                scalar_t feedforward = friction + kV * setpoint.velocity + kA * setpoint.acceleration + gravity;
+
+                // move along the profile to the angle requested by the state machine
+                pid.alterTarget(setpoint.position);
+                int32_t voltage = pid.calcPower(angle, feedforward);
+                voltage = std::max(std::min(voltage, voltageLimit), -voltageLimit);
+
+                // only send the voltage to the motor if it changed
+                if (lastVoltage == noVoltage || std::abs(voltage - lastVoltage) >= voltageDeadband) {
+                    motor.move_voltage(voltage);
+                    lastVoltage = voltage;
+                }
+
+                settled = (time - profileStartTime >= profile.getDuration() * 1e6
+                    && fabs(angles[pos] - angle) <= settledError);
 
-            size_t pos = (liftIsUp ? 3 : 0); // set index to high and neutral subposition if liftIsUp
-            if (subposition == Subposition::high) { // go up an angle in angles if high subposition
-                ++pos;
-            } else if (subposition == Subposition::low && pos != 0) { // if raised and low subposition, go down an angle in angles
-                --pos;
             }
 
-            // move to the angle requested by the state machine
-            motor.move_absolute(angles[pos], 100);
+            // once settled, the motor's own position controller holds the preset, so the state machine only needs to
+            // supervise at the low rate until a new state is requested (repeated hold commands are not sent)
+            // the position controller cannot be voltage limited, so a stalled or derated lift stays under voltage control
+            holding = (settled && voltageLimit == 12000);
+            if (holding) {
+                motor.move_absolute(angles[pos], holdVelocity);
+                lastVoltage = noVoltage; // the next profile's first voltage must be sent
+                period = supervisionPeriod;
+            }
 
         }
 
     mutex.give();
+        return period;
+    }
+
+    // Writes the supervision event log, oldest first, as csv (time in milliseconds, event, position, current,
+    // temperature) to file
+    void Lift::writeEventLog(FILE* file) {
+    mutex.take();
+        static const char* const eventNames[] = {"stall", "stall cleared", "zeroed", "derating", "derate cleared"};
+        fprintf(file, "time,event,position,current,temperature\n");
+        size_t oldest = (loggedEvents > logCapacity ? loggedEvents - logCapacity : 0);
+        for (size_t i = oldest; i < loggedEvents; ++i) {
+            const LogEntry& entry = eventLog[i % logCapacity];
+            fprintf(file, "%lu,%s,%.1f,%.0f,%.0f\n",
+                static_cast<unsigned long>(entry.time), eventNames[static_cast<size_t>(entry.event)],
+                static_cast<double>(entry.position), static_cast<double>(entry.current),
+                static_cast<double>(entry.temperature)
+            );
+        }
+    mutex.give();
+    }
+
+    // wakes the systems task so a state change is acted on immediately
+    void Lift::notifyStateChange() {
+        systemsTask.notify();
+    }
+
+    // returns the index in angles requested by liftIsUp and subposition
+    size_t Lift::requestedIndex() {
+        size_t pos = (liftIsUp ? 3 : 0); // set index to high and neutral subposition if liftIsUp
+        if (subposition == Subposition::high) { // go up an angle in angles if high subposition
+            ++pos;
+        } else if (subposition == Subposition::low && pos != 0) { // if raised and low subposition, go down an angle in angles
+            --pos;
+        }
+        return pos;
+    }
+
+    // Detects stalls (zeroing the encoder on the bottom hard stop) and sets the voltage limit from the motor temperature
+    void Lift::supervise(const SensorHub::Snapshot& snapshot) {
+
+        // holding a preset draws current without moving (more so with a goal in the claw), which is not a stall,
+        // so stalls are only detected while the profile moves the lift or the lift is away from its preset
+        bool holdingPreset = !usingManualControl && targetIndex != noTarget
+            && snapshot.time >= profileStartTime + profile.getDuration() * 1e6
+            && fabs(angles[targetIndex] - snapshot.liftPosition) <= settledError;
+
+        // stalled: drawing high current without moving
+        if (holdingPreset || fabs(snapshot.liftVelocity) >= stallVelocity || !(fabs(snapshot.liftCurrent) >= stallCurrent)) {
+            stallStartTime = 0;
+            if (stalled) {
+                stalled = false;
+                logEvent(Event::stallCleared, snapshot);
+            }
+        } else if (stallStartTime == 0) {
+            stallStartTime = snapshot.time;
+        } else if (!stalled && snapshot.time - stallStartTime >= stallTime * 1000) {
+            stalled = true;
+            logEvent(Event::stall, snapshot);
+            // pushing down near 0, the lift is on the bottom hard stop
+            if (snapshot.liftVoltage < 0 && snapshot.liftPosition < zeroWindow) {
+                motor.tare_position();
+                zeroTime = pros::micros();
+                ++zeroCount;
+                targetIndex = noTarget;
+                lastVoltage = noVoltage;
+                logEvent(Event::zeroed, snapshot);
+            }
+        }
+
+        // derate linearly from full voltage at derateStartTemperature to minVoltageFraction at derateEndTemperature
+        scalar_t fraction = 1;
+        if (snapshot.liftTemperature > derateStartTemperature) { // false if the temperature could not be read (NAN)
+            scalar_t heat = (snapshot.liftTemperature - derateStartTemperature) / (derateEndTemperature - derateStartTemperature);
+            fraction = std::max(1 - heat * (1 - minVoltageFraction), minVoltageFraction);
+        }
+        if ((fraction < 1) != derating) {
+            derating = !derating;
+            logEvent(derating ? Event::derating : Event::derateCleared, snapshot);
+        }
+
+        voltageLimit = 12000 * fraction;
+        if (stalled) {
+            voltageLimit = std::min(voltageLimit, stallVoltageLimit);
+        }
+
+    }
+
+    // Adds an event to the log, overwriting the oldest if the log is full
+    void Lift::logEvent(Event event, const SensorHub::Snapshot& snapshot) {
+        eventLog[loggedEvents % logCapacity] = {
+            pros::millis(), event, snapshot.liftPosition, snapshot.liftCurrent, snapshot.liftTemperature
+        };
+        ++loggedEvents;
     }
 
 } // namespace motor_control
\ No newline at end of file
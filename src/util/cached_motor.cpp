@@ -0,0 +1,105 @@
+#include "util/cached_motor.hpp"
+#include "pros/rtos.hpp"
+
+namespace motor_control {
+
+    std::atomic<uint32_t> CachedMotor::totalWrites          {0};
+    std::atomic<uint32_t> CachedMotor::totalSkippedWrites   {0};
+    std::atomic<uint32_t> CachedMotor::countStartTime       {0};
+
+    // constructor, same parameters as pros::Motor
+    CachedMotor::CachedMotor(std::uint8_t port, pros::motor_gearset_e_t gearset, bool reverse)
+        : pros::Motor {port, gearset, reverse} {}
+
+    // pros::Motor commands, skipped (returning 1, success) if equal to the last command sent
+
+    std::int32_t CachedMotor::move(std::int32_t voltage) const {
+        return (skip(Command::move, voltage) ? 1 : pros::Motor::move(voltage));
+    }
+
+    std::int32_t CachedMotor::move_absolute(const double position, const std::int32_t velocity) const {
+        return (skip(Command::moveAbsolute, position, velocity) ? 1 : pros::Motor::move_absolute(position, velocity));
+    }
+
+    std::int32_t CachedMotor::move_velocity(const std::int32_t velocity) const {
+        return (skip(Command::moveVelocity, velocity) ? 1 : pros::Motor::move_velocity(velocity));
+    }
+
+    std::int32_t CachedMotor::move_voltage(const std::int32_t voltage) const {
+        return (skip(Command::moveVoltage, voltage) ? 1 : pros::Motor::move_voltage(voltage));
+    }
+
+    // always sent, clears the cached command
+
+    std::int32_t CachedMotor::move_relative(const double position, const std::int32_t velocity) const {
+        skip(Command::none, 0); // count the write
+        return pros::Motor::move_relative(position, velocity);
+    }
+
+    std::int32_t CachedMotor::tare_position() const {
+        invalidate();
+        return pros::Motor::tare_position();
+    }
+
+    std::int32_t CachedMotor::set_zero_position(const double position) const {
+        invalidate();
+        return pros::Motor::set_zero_position(position);
+    }
+
+    // clears the cached command so the next command is sent
+    void CachedMotor::invalidate() const {
+        lastCommand = Command::none;
+    }
+
+    // returns the number of commands sent to and skipped for this motor
+    uint32_t CachedMotor::getWrites() const {
+        return writes;
+    }
+
+    uint32_t CachedMotor::getSkippedWrites() const {
+        return skippedWrites;
+    }
+
+    // restarts the traffic measurement of every CachedMotor
+    void CachedMotor::resetWriteCounts() {
+        totalWrites.store(0, std::memory_order_relaxed);
+        totalSkippedWrites.store(0, std::memory_order_relaxed);
+        countStartTime.store(pros::millis(), std::memory_order_relaxed);
+    }
+
+    // return the commands sent and skipped per second, over every CachedMotor, since resetWriteCounts was called
+
+    scalar_t CachedMotor::getWriteRate() {
+        uint32_t elapsed = pros::millis() - countStartTime.load(std::memory_order_relaxed);
+        return (elapsed == 0 ? 0 : totalWrites.load(std::memory_order_relaxed) * static_cast<scalar_t>(1000) / elapsed);
+    }
+
+    scalar_t CachedMotor::getSkippedWriteRate() {
+        uint32_t elapsed = pros::millis() - countStartTime.load(std::memory_order_relaxed);
+        return (elapsed == 0 ? 0 : totalSkippedWrites.load(std::memory_order_relaxed) * static_cast<scalar_t>(1000) / elapsed);
+    }
+
+    // returns true if the command can be skipped, otherwise records it as the last command sent
+    // updates the write counts
+    bool CachedMotor::skip(Command command, double value, std::int32_t velocity) const {
+
+        uint32_t time = pros::millis();
+        if (command != Command::none && command == lastCommand && value == lastValue && velocity == lastVelocity
+            && time - lastWriteTime < refreshPeriod
+        ) {
+            ++skippedWrites;
+            totalSkippedWrites.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        lastCommand     = command;
+        lastValue       = value;
+        lastVelocity    = velocity;
+        lastWriteTime   = time;
+        ++writes;
+        totalWrites.fetch_add(1, std::memory_order_relaxed);
+        return false;
+
+    }
+
+} // namespace motor_control
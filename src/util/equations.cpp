@@ -5,18 +5,18 @@
 namespace equations {
 
     // returns the distance between two points given the difference in their x and y positions
-    double distance(double dx, double dy) {
+    scalar_t distance(scalar_t dx, scalar_t dy) {
         return sqrt(dx * dx + dy * dy); // more performant than std::hypot
     }
 
     // constructor, with coefficients of terms followed by the power that respective term is raised to
-    PolynomialEquation::PolynomialEquation(long double a, int pow1, long double b, int pow2, long double c,
-        int pow3, long double d, int pow4, long double e, int pow5)
+    PolynomialEquation::PolynomialEquation(scalar_t a, int pow1, scalar_t b, int pow2, scalar_t c,
+        int pow3, scalar_t d, int pow4, scalar_t e, int pow5)
         : a {a}, b {b}, c {c}, d {d}, e {e},
         pow1 {pow1}, pow2 {pow2}, pow3 {pow3}, pow4 {pow4}, pow5 {pow5} {}
 
     // returns the value of the function at the given point
-    long double PolynomialEquation::at(long double value) const {
+    scalar_t PolynomialEquation::at(scalar_t value) const {
         return a * pow(value, pow1) +  b * pow(value, pow2) + c * pow(value, pow3)
             + d * pow(value, pow4) + e * pow(value, pow5);
     }
@@ -38,14 +38,14 @@ namespace equations {
         : xd {xd}, xdd {xdd}, yd {yd}, ydd {ydd} {}
 
     // returns the curvature (which is equivalent to 1 / r) at a current value along a parametric curve
-    long double CurvatureEquation::at(long double value) const {
+    scalar_t CurvatureEquation::at(scalar_t value) const {
         return (xd.at(value) * ydd.at(value) - xdd.at(value) * yd.at(value))
             / pow(pow(xd.at(value), 2) + pow(yd.at(value), 2), 1.5);
     }
 
     // constructor, takes the first derivatives of the x and y components of a parametric equation as well as a time step
     // a higher time step will yield a more accurate answer at the expense of computation time
-    DistanceToTime::DistanceToTime(const PolynomialEquation& xd, const PolynomialEquation& yd, long double step)
+    DistanceToTime::DistanceToTime(const PolynomialEquation& xd, const PolynomialEquation& yd, scalar_t step)
         : xd {xd}, yd {yd}, step {step}, time {0}, accumulatedDistance {0} {}
 
     // Converts a distance along a parametric path to the value of the parametric parameter
@@ -53,7 +53,7 @@ namespace equations {
     // For optimization, it is assumed that the values of dist subsequently
     // passed to atDistance of an instance of DistanceToTime are always increasing
     // A value from 0 to 1 is returned
-    long double DistanceToTime::atDistance(long double dist) {
+    scalar_t DistanceToTime::atDistance(scalar_t dist) {
 
         while (accumulatedDistance * step < dist && time < 1) { // while not enough of the path has been transversed
             // approximate the distance transversed using a trapezoidal approximation
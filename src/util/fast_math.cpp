@@ -0,0 +1,93 @@
+#include "util/fast_math.hpp"
+#include "util/conversions.hpp"
+
+#include <cmath>
+
+namespace fast_math {
+
+    using conversions::pi;
+
+    // returns the sine of angle, for angle on the interval [-pi / 2, pi / 2]
+    // Taylor series through the x^9 term, the error is largest (under 0.000004) at the ends of the interval
+    static scalar_t sinKernel(scalar_t angle) {
+        scalar_t angleSquared = angle * angle;
+        return angle * (1 + angleSquared * (-1 / 6.0 + angleSquared * (1 / 120.0
+            + angleSquared * (-1 / 5040.0 + angleSquared * (1 / 362880.0)))));
+    }
+
+    // returns the cosine of angle, for angle on the interval [-pi / 2, pi / 2]
+    // Taylor series through the x^10 term, the error is largest (under 0.000001) at the ends of the interval
+    static scalar_t cosKernel(scalar_t angle) {
+        scalar_t angleSquared = angle * angle;
+        return 1 + angleSquared * (-1 / 2.0 + angleSquared * (1 / 24.0 + angleSquared * (-1 / 720.0
+            + angleSquared * (1 / 40320.0 + angleSquared * (-1 / 3628800.0)))));
+    }
+
+    // wraps angle to be on the interval [-pi, pi]
+    static scalar_t wrap(scalar_t angle) {
+        return angle - 2 * pi * std::floor(angle / (2 * pi) + 0.5);
+    }
+
+    // returns the sine of angle
+    scalar_t sin(scalar_t angle) {
+        angle = wrap(angle);
+        // sin(x) = sin(pi - x), reflect into [-pi / 2, pi / 2]
+        if (angle > pi / 2) {
+            angle = pi - angle;
+        } else if (angle < -pi / 2) {
+            angle = -pi - angle;
+        }
+        return sinKernel(angle);
+    }
+
+    // returns the cosine of angle
+    scalar_t cos(scalar_t angle) {
+        return sin(angle + pi / 2);
+    }
+
+    // sets sine and cosine to the sine and cosine of angle, cheaper than calling sin and cos separately
+    void sincos(scalar_t angle, scalar_t& sine, scalar_t& cosine) {
+        angle = wrap(angle);
+        // reflect into [-pi / 2, pi / 2], which flips the sign of cosine
+        scalar_t cosineSign = 1;
+        if (angle > pi / 2) {
+            angle = pi - angle;
+            cosineSign = -1;
+        } else if (angle < -pi / 2) {
+            angle = -pi - angle;
+            cosineSign = -1;
+        }
+        sine = sinKernel(angle);
+        cosine = cosineSign * cosKernel(angle);
+    }
+
+    // returns the angle, on the interval [-pi, pi], of the point (x, y) from the positive x axis
+    scalar_t atan2(scalar_t y, scalar_t x) {
+
+        scalar_t absX = std::fabs(x);
+        scalar_t absY = std::fabs(y);
+        if (absX == 0 && absY == 0) {
+            return 0; // matches std::atan2(0, 0)
+        }
+
+        // evaluate atan on [0, 1] by taking the ratio of the smaller to the larger component
+        bool swapped = absY > absX;
+        scalar_t ratio = swapped ? absX / absY : absY / absX;
+
+        // minimax polynomial for atan on [-1, 1] (Abramowitz and Stegun 4.4.49), error under 0.00001 radians
+        scalar_t ratioSquared = ratio * ratio;
+        scalar_t angle = ratio * (0.9998660 + ratioSquared * (-0.3302995 + ratioSquared * (0.1801410
+            + ratioSquared * (-0.0851330 + ratioSquared * 0.0208351))));
+
+        // undo the range reduction
+        if (swapped) {
+            angle = pi / 2 - angle;
+        }
+        if (x < 0) {
+            angle = pi - angle;
+        }
+        return y < 0 ? -angle : angle;
+
+    }
+
+} // namespace fast_math
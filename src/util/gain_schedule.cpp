@@ -0,0 +1,57 @@
+#include "util/gain_schedule.hpp"
+
+namespace motor_control {
+
+    // constructs an empty schedule, PIDController uses its constant gains
+    GainSchedule::GainSchedule() : key {Key::motionSize}, entries {}, length {0} {}
+
+    // constructor, entries must be sorted by key (ascending); entries beyond maxEntries are ignored
+    GainSchedule::GainSchedule(Key key, std::initializer_list<Entry> newEntries) : key {key}, entries {}, length {0} {
+        for (const Entry& entry : newEntries) {
+            if (length == maxEntries) {
+                break;
+            }
+            entries[length] = entry;
+            ++length;
+        }
+    }
+
+    // returns true if there are no entries (the schedule is unused)
+    bool GainSchedule::empty() const {
+        return length == 0;
+    }
+
+    // returns the value the gains are scheduled by
+    GainSchedule::Key GainSchedule::getKey() const {
+        return key;
+    }
+
+    // returns the gains interpolated at value, do not call on an empty schedule
+    GainSchedule::Entry GainSchedule::at(scalar_t value) const {
+
+        // use the nearest entry outside of the table
+        if (value <= entries[0].key) {
+            return entries[0];
+        } else if (value >= entries[length - 1].key) {
+            return entries[length - 1];
+        }
+
+        // find the entries surrounding value, and linearly interpolate between them
+        size_t i = 1;
+        while (entries[i].key < value) {
+            ++i;
+        }
+        const Entry& low = entries[i - 1];
+        const Entry& high = entries[i];
+        scalar_t t = (value - low.key) / (high.key - low.key);
+
+        return {
+            value,
+            low.kP + t * (high.kP - low.kP),
+            low.kD + t * (high.kD - low.kD),
+            low.kI + t * (high.kI - low.kI)
+        };
+
+    }
+
+} // namespace motor_control
@@ -10,29 +10,37 @@ namespace motor_control {
     // integral cap limits the max voltage that the integral term can supply
     // the last three parameters dictate slew control, and have units of volts/s^s, volts, and volts respectively
     // if voltageAcceleration <= 0, slew control will not be used
-    PIDController::PIDController(long double kP, long double kD, long double kI, long double integralCap,
-        long double voltageAcceleration, long double maxVoltage, long double startingVoltage)
+    // derivativeFilterTime is the time constant (seconds) of the derivative low pass filter, 0 disables the filter
+    // if gainSchedule is not empty, it overrides kP, kD, and kI for motions it applies to
+    PIDController::PIDController(scalar_t kP, scalar_t kD, scalar_t kI, scalar_t integralCap,
+        scalar_t voltageAcceleration, scalar_t maxVoltage, scalar_t startingVoltage,
+        scalar_t derivativeFilterTime, const GainSchedule& gainSchedule)
         : kP {kP}, kD {kD}, kI {kI}, integralCap {integralCap},
+        constantKP {kP}, constantKD {kD}, constantKI {kI},
+        gainSchedule {gainSchedule},
+        derivativeFilterTime {(derivativeFilterTime > 0 ? derivativeFilterTime : 0)},
         voltageAcceleration {voltageAcceleration},
         maxVoltage {(maxVoltage > 0 && maxVoltage <= 12 ? maxVoltage : 12)},
         startingVoltage {startingVoltage} {}
 
     // returns the error of the system when calcPower was last run
-    long double PIDController::getError() {
+    scalar_t PIDController::getError() {
         return error;
     }
 
-    // returns the derivative of the system when calc power was last run
-    long double PIDController::getDerivative() {
+    // returns the (filtered) derivative of the error when calc power was last run
+    scalar_t PIDController::getDerivative() {
         return derivative;
     }
 
     // resets the PIDController and sets a new target
     // if ignoreProfile is true, slew is disabled until the next reset, otherwise slew is enabled (if voltageAcceleration > 0)
-    void PIDController::setNewTarget(long double newTarget, bool ignoreProfile) {
+    // motionSize is the size of the motion for gain schedules keyed by motion size, NAN uses the constant gains
+    void PIDController::setNewTarget(scalar_t newTarget, bool ignoreProfile, scalar_t motionSize) {
         
         // reset state variables
         target      = newTarget;
+        scheduleMotionSize = motionSize;
         error       = 0;
         prevError   = 0;
         derivative  = 0;
@@ -40,6 +48,7 @@ namespace motor_control {
 
         // mark the next calcPower call as the first for the motion
         firstRun = true;
+        reseedDerivative = false;
 
         // update the slew profile by conditionally enabling it and updating the initial slew output
         usingSlew = (!ignoreProfile && voltageAcceleration > 0);
@@ -48,10 +57,17 @@ namespace motor_control {
     }
 
     // changes the target, does not reset slew, derivative, or integral terms
-    void PIDController::alterTarget(long double newTarget) {
+    void PIDController::alterTarget(scalar_t newTarget) {
         target = newTarget;
     }
 
+    // changes the target without resetting slew or integral terms, used to blend one motion into the next
+    // the derivative is reseeded during the next calcPower call, so the jump in error does not cause a derivative kick
+    void PIDController::blendTarget(scalar_t newTarget) {
+        target = newTarget;
+        reseedDerivative = true;
+    }
+
     // Inform the PIDController of updates to the system's output since calcPower was last ran
     // (example: after a motion that does not utilize PID)
     // units are millivolts for consistency with calcPower
@@ -60,41 +76,63 @@ namespace motor_control {
     }
 
     // returns a suggestion for the millivolts to supply to the system, based off of the current position of said system
+    // feedforward (volts) is added to the PID output before it is bounded and slewed
     // units are millivolts because pros::Motor::move_voltage uses millivolts
-    int PIDController::calcPower(long double currPos) {
+    int PIDController::calcPower(scalar_t currPos, scalar_t feedforward) {
 
-        // state variable to track the direction of slew acceleration
-        static bool positiveSlewAcceleration = true;
-
-        uint32_t currTime = pros::millis();
-        long double dt = (currTime - startTime) / 1000.0L; // important for slew, integral, and derivative terms
+        uint64_t currTime = pros::micros();
+        scalar_t dt = (currTime - startTime) / 1000000.0; // important for slew, integral, and derivative terms
+        bool motionStart = firstRun;
         if (firstRun) {
             // Update slew starting power and direction at the start of a new motion, prevent dt from
             // causing the calculations to be skipped and the previous output (which is not reset) to be returned
             // This also causes error to be properly tracked on motion start if dt is 0
             dt = 0.01;
+            if (!gainSchedule.empty()) { // schedule the gains for the motion
+                applyGainSchedule(
+                    gainSchedule.getKey() == GainSchedule::Key::motionSize ? scheduleMotionSize : scheduleSpeed
+                );
+            }
             if (usingSlew) {
-                error = target - currPos;
-                positiveSlewAcceleration = (error >= 0);
+                positiveSlewAcceleration = (target - currPos >= 0);
                 slewPower += startingVoltage * (positiveSlewAcceleration ? 1 : -1);
             }
             firstRun = false;
         } else if (dt == 0) {
-            return previousOutput;
+            return previousOutput * 1000; // convert from volts to millivolts
         }
 
         // update state variables for next function call
         startTime = currTime;
         prevError = error;
 
-        // integrate, find and limit integral term
+        // find error, integrate, find and limit integral term
+        error = target - currPos;
         totalError += error * dt;
-        long double integralTerm = std::clamp(kI * totalError, -integralCap, integralCap);
+        scalar_t integralTerm = std::clamp(kI * totalError, -integralCap, integralCap);
+
+        // find the derivative of the error
+        scalar_t rawDerivative;
+        if (motionStart) { // no previous measurement for the motion, a derivative would kick the output
+            rawDerivative = 0;
+            derivative = 0;
+        } else if (derivativeOnMeasurement) { // unaffected by target changes
+            rawDerivative = (prevPos - currPos) / dt;
+        } else if (reseedDerivative) { // the target was blended, hold the derivative rather than reacting to the jump in error
+            rawDerivative = derivative;
+        } else {
+            rawDerivative = (error - prevError) / dt;
+        }
+        reseedDerivative = false;
+        prevPos = currPos;
 
-        // find error, derivative, sum up weighted P, I, and D and bound the result
-        error = target - currPos;
-        derivative = (error - prevError) / dt;
-        long double pidOutput = std::clamp(kP * error + kD * derivative + integralTerm, -maxVoltage, maxVoltage);
+        // low pass filter the derivative to reject sensor noise
+        derivative += (derivativeFilterTime > 0 ? dt / (derivativeFilterTime + dt) : 1) * (rawDerivative - derivative);
+
+        // sum up weighted P, I, D and the feedforward and bound the result
+        scalar_t pidOutput = std::clamp(
+            kP * error + kD * derivative + integralTerm + feedforward, -maxVoltage, maxVoltage
+        );
 
         if (usingSlew) { // if motion profiling the beginning of a motion
 
@@ -116,24 +154,25 @@ namespace motor_control {
 
     }
 
-    // returns the current gains for both PID and slew
+    // returns the current gains for both PID and slew (the scheduled gains if the motion is scheduled)
     PIDController::Constants PIDController::getConstants() {
         return {
             kP, kD, kI, integralCap,
-            voltageAcceleration, maxVoltage, startingVoltage
+            voltageAcceleration, maxVoltage, startingVoltage,
+            derivativeFilterTime, derivativeOnMeasurement
         };
     }
 
-    // sets the PID gains
+    // sets the constant PID gains, used for motions the gain schedule does not apply to
     // note the derivative gain (newKD) comes before the integral gain (newKI)
-    void PIDController::setConstants(long double newKP, long double newKD, long double newKI, long double newIntegralCap) {
-        kP = newKP; kD = newKD; kI = newKI; integralCap = newIntegralCap;
+    void PIDController::setConstants(scalar_t newKP, scalar_t newKD, scalar_t newKI, scalar_t newIntegralCap) {
+        kP = constantKP = newKP; kD = constantKD = newKD; kI = constantKI = newKI; integralCap = newIntegralCap;
     }
 
     // sets the slew constants with units of volts/s^s, volts, and volts respectively
     // if voltageAcceleration <= 0, slew control will not be used
     void PIDController::setSlewConstants(
-        long double newVoltageAcceleration, long double newMaxVoltage, long double newStartingVoltage
+        scalar_t newVoltageAcceleration, scalar_t newMaxVoltage, scalar_t newStartingVoltage
     ) {
 
         voltageAcceleration = newVoltageAcceleration;
@@ -147,4 +186,31 @@ namespace motor_control {
 
     }
 
+    // sets the time constant (seconds) of the derivative low pass filter, and whether the derivative is taken on the measurement
+    // taking the derivative on the measurement requires currPos to be continuous when the target changes
+    void PIDController::setDerivativeFilter(scalar_t newDerivativeFilterTime, bool newDerivativeOnMeasurement) {
+        derivativeFilterTime = (newDerivativeFilterTime > 0 ? newDerivativeFilterTime : 0);
+        derivativeOnMeasurement = newDerivativeOnMeasurement;
+    }
+
+    // sets the gain schedule, pass an empty GainSchedule to use constant gains
+    void PIDController::setGainSchedule(const GainSchedule& newGainSchedule) {
+        gainSchedule = newGainSchedule;
+    }
+
+    // sets the commanded speed used by gain schedules keyed by GainSchedule::Key::speed, applied at the start of the next motion
+    void PIDController::setScheduleSpeed(scalar_t speed) {
+        scheduleSpeed = speed;
+    }
+
+    // sets kP, kD, and kI to the scheduled gains at value, or to the constant gains if value is NAN
+    void PIDController::applyGainSchedule(scalar_t value) {
+        if (std::isnan(value)) {
+            kP = constantKP; kD = constantKD; kI = constantKI;
+            return;
+        }
+        GainSchedule::Entry gains = gainSchedule.at(value);
+        kP = gains.kP; kD = gains.kD; kI = gains.kI;
+    }
+
 } // namespace motor_control
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "pros/misc.h"
 #include "pros/misc.hpp"
 #include "systems.hpp"
+#include "sensor_hub.hpp"
 #include "gui/display.hpp"
 #include "macros.h"
 #include "pros/rtos.h"
@@ -10,17 +11,40 @@
  * This file contains user created tasks
  *
  * mainTasks concerns everything relating to the Drivetrain
- * systemsTasks concerns everything relating to subsystem 3
+ * systemsTasks concerns everything relating to subsystem 3, it wakes when the lift state changes or when the lift needs updating
+ * driveTasks executes motions queued by the asynchronous Drivetrain movement functions
+ * odometryTasks runs odometry in place of mainTasks when it runs faster than mainTasks (ROTATION_SENSOR_ODOMETRY)
+ * sensorTasks samples the devices into SensorHub snapshots, which the other tasks read
  */
 
 /* Initialize tasks */
 
+void sensorTasks(void*);
+pros::Task sensorTask(sensorTasks, nullptr, TASK_PRIORITY_DEFAULT + 2); // above odometry so snapshots are ready when it runs
+
 void mainTasks(void*);
 pros::Task mainTask(mainTasks);
 
 void systemsTasks(void*);
 pros::Task systemsTask(systemsTasks);
 
+void driveTasks(void*);
+pros::Task driveTask(driveTasks);
+
+#ifdef ROTATION_SENSOR_ODOMETRY
+void odometryTasks(void*);
+pros::Task odometryTask(odometryTasks, nullptr, TASK_PRIORITY_DEFAULT + 1); // above the control loops so timing is steady
+#endif
+
+// samples the devices every tick, even while the IMUs calibrate (failed readings are ignored by the readers)
+void sensorTasks(void*) {
+    while (true) {
+        uint32_t startTime = pros::millis();
+        SensorHub::sample();
+        pros::Task::delay_until(&startTime, SensorHub::samplePeriod);
+    }
+}
+
 // mainTasks calibrates / resets Drivetrain sensors, marks calibration as complete, and then runs odometry and updates the GUI
 void mainTasks(void*) {
 
@@ -41,8 +65,7 @@ void mainTasks(void*) {
         pros::delay(10);
     }
 
-    Drivetrain::parallelTrackingWheel.reset();
-    Drivetrain::perpendicularTrackingWheel.reset();
+    Drivetrain::trackingWheels.reset();
 
 Drivetrain::positionDataMutex.take(20); // timeout and prevent deadlock if other task exits without freeing the mutex
     Drivetrain::calibrated = true; // mark calibration as complete
@@ -50,15 +73,13 @@ Drivetrain::positionDataMutex.give();
 
     while (true) {
 
-    Drivetrain::positionDataMutex.take(20);
-
         uint32_t startTime = pros::millis();
 
-#ifndef BRAIN_SCREEN_GAME_MODE
+#if !defined(BRAIN_SCREEN_GAME_MODE) && !defined(ROTATION_SENSOR_ODOMETRY)
+    Drivetrain::positionDataMutex.take(20);
         Drivetrain::trackPosition(); // run odometry and update tracked position
-#endif
-
     Drivetrain::positionDataMutex.give();
+#endif
 
 #ifndef DISPLAY_DEBUG
         if (displayActive) {
@@ -86,12 +107,38 @@ Drivetrain::positionDataMutex.give();
 
 }
 
+#ifdef ROTATION_SENSOR_ODOMETRY
+// waits until mainTasks has reset the Drivetrain sensors, then runs odometry at the update rate of the tracking wheels
+void odometryTasks(void*) {
+    Drivetrain::waitUntilCalibrated();
+    while (true) {
+        uint32_t startTime = pros::millis();
+#ifndef BRAIN_SCREEN_GAME_MODE
+    Drivetrain::positionDataMutex.take(20);
+        Drivetrain::trackPosition(); // run odometry and update tracked position
+    Drivetrain::positionDataMutex.give();
+#endif
+        pros::Task::delay_until(&startTime, Drivetrain::trackingWheels.getUpdatePeriod());
+    }
+}
+#endif
+
 // zeros the lift and sets it to use degrees, then runs a state machine to supply power to the lift
+// the state machine runs when the requested lift state changes, or when powerLift asks to be run again
 void systemsTasks(void*) {
     motor_control::Lift::init();
     while (true) {
         uint32_t startTime = pros::millis();
-        motor_control::Lift::powerLift();
-        pros::Task::delay_until(&startTime, 10);
+        uint32_t period = motor_control::Lift::powerLift();
+        uint32_t elapsed = pros::millis() - startTime;
+        pros::Task::notify_take(true, (period > elapsed ? period - elapsed : 0)); // sleep until a state change or the period ends
+    }
+}
+
+// waits until motions are queued, then executes them in order
+void driveTasks(void*) {
+    while (true) {
+        pros::Task::notify_take(true, TIMEOUT_MAX); // sleep until a motion is queued
+        Drivetrain::runQueuedMotions();
     }
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "util/trapezoidal_profile.hpp"
+
+#include <cmath>
+
+namespace motor_control {
+
+    // constructor, maxVelocity and maxAcceleration must be positive
+    // the profile is at rest at position 0 until plan is called
+    TrapezoidalProfile::TrapezoidalProfile(scalar_t maxVelocity, scalar_t maxAcceleration)
+        : maxVelocity {maxVelocity}, maxAcceleration {maxAcceleration} {}
+
+    // plans a profile from start, moving with startVelocity, to rest at target
+    void TrapezoidalProfile::plan(scalar_t newStart, scalar_t newTarget, scalar_t newStartVelocity) {
+
+        start = newStart;
+        target = newTarget;
+        direction = (target >= start ? 1 : -1);
+        scalar_t distance = fabs(target - start);
+
+        // work in the direction of the target, moving away from it is a negative velocity
+        // limit the starting velocity to one the profile can stop from before reaching the target
+        startVelocity = fmax(fmin(newStartVelocity * direction, maxVelocity), -maxVelocity);
+        startVelocity = fmin(startVelocity, sqrt(2 * maxAcceleration * distance));
+
+        // the distance covered speeding up from startVelocity to the peak, then slowing from the peak to rest, is the distance
+        // (peak^2 - start^2) / 2a + peak^2 / 2a = distance
+        peakVelocity = sqrt(maxAcceleration * distance + startVelocity * startVelocity / 2);
+        scalar_t cruiseTime = 0;
+        if (peakVelocity > maxVelocity) {
+            peakVelocity = maxVelocity;
+            scalar_t rampDistance = (2 * maxVelocity * maxVelocity - startVelocity * startVelocity) / (2 * maxAcceleration);
+            cruiseTime = (distance - rampDistance) / maxVelocity;
+        }
+
+        accelerationEnd = (peakVelocity - startVelocity) / maxAcceleration;
+        cruiseEnd = accelerationEnd + cruiseTime;
+        decelerationEnd = cruiseEnd + peakVelocity / maxAcceleration;
+
+    }
+
+    // returns the planned state time seconds after the start of the profile
+    // times after the end of the profile return the target at rest
+    TrapezoidalProfile::State TrapezoidalProfile::at(scalar_t time) const {
+
+        if (time >= decelerationEnd) {
+            return {target, 0, 0};
+        }
+        time = fmax(time, 0);
+
+        scalar_t distance, velocity, acceleration;
+        if (time < accelerationEnd) {
+            acceleration = maxAcceleration;
+            velocity = startVelocity + maxAcceleration * time;
+            distance = (startVelocity + velocity) * time / 2;
+        } else {
+            scalar_t accelerationDistance = (startVelocity + peakVelocity) * accelerationEnd / 2;
+            if (time < cruiseEnd) {
+                acceleration = 0;
+                velocity = peakVelocity;
+                distance = accelerationDistance + peakVelocity * (time - accelerationEnd);
+            } else {
+                scalar_t decelerationTime = time - cruiseEnd;
+                acceleration = -maxAcceleration;
+                velocity = peakVelocity - maxAcceleration * decelerationTime;
+                distance = accelerationDistance + peakVelocity * (cruiseEnd - accelerationEnd)
+                    + (peakVelocity + velocity) * decelerationTime / 2;
+            }
+        }
+
+        return {start + direction * distance, direction * velocity, direction * acceleration};
+
+    }
+
+    // returns the time (seconds) the profile takes to reach the target
+    scalar_t TrapezoidalProfile::getDuration() const {
+        return decelerationEnd;
+    }
+
+    // returns the target of the profile
+    scalar_t TrapezoidalProfile::getTarget() const {
+        return target;
+    }
+
+} // namespace motor_control